@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Parser.h>
+#include <Parameter.h>
+#include <Constant.h>
+#include <Bytecode.h>
+
+int main(int argc, char* argv[]) {
+
+    std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::string filename = "bench_bytecode.qasm";
+    {
+        std::ofstream out(filename);
+        out << "OPENQASM 2.0;\n";
+        out << "gate g(t, s) q {\n";
+        out << "    U(sin(t*pi/2) + s/2.5, sqrt(2)*cos(t) - pi/4, exp(-t^2) + ln(2)*s) q;\n";
+        out << "    U(t, -s, (t + s)*(t - s)/(1 + t^2)) q;\n";
+        out << "    U(tan(s/4)^2, pi/2, t*s*sqrt(3)) q;\n";
+        out << "}\n";
+    }
+
+    kazm::Parser parser;
+    parser.parse(filename);
+    std::remove(filename.c_str());
+
+    kazm::Gate* gate = nullptr;
+    for (kazm::Gate* g : parser.gates) {
+        if (g && g->name == "g") gate = g;
+    }
+
+    std::vector<kazm::Parameter*> params;
+    for (std::size_t i = 0; i < gate->nparams; i++) params.push_back(dynamic_cast<kazm::Parameter*>(gate->pstack[i]));
+    std::vector<kazm::Expression*> exprs(gate->pstack.begin() + gate->nparams, gate->pstack.end());
+
+    std::vector<kazm::Bytecode> code(exprs.size());
+    std::size_t depth = 0;
+    for (std::size_t i = 0; i < exprs.size(); i++) {
+        exprs[i]->compile(code[i]);
+        if (code[i].max_depth > depth) depth = code[i].max_depth;
+    }
+
+    const std::size_t nvalues = 1024;
+    std::vector<double> values(nvalues * params.size());
+    std::vector<kazm::Constant*> constants(values.size());
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = 0.001 * i;
+        constants[i] = parser.arena.make<kazm::Constant>(std::to_string(values[i]), values[i]);
+    }
+
+    double tree_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; r++) {
+        std::size_t v = r % nvalues * params.size();
+        for (std::size_t p = 0; p < params.size(); p++) params[p]->value = constants[v+p];
+        for (kazm::Expression* e : exprs) tree_sum += e->evaluate();
+    }
+    double tree = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double code_sum = 0;
+    std::vector<double> stack(depth);
+    start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; r++) {
+        const double* args = &values[r % nvalues * params.size()];
+        for (const kazm::Bytecode& c : code) code_sum += c.evaluate(args, stack.data());
+    }
+    double bytecode = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t evaluations = rounds * exprs.size();
+    std::cout << exprs.size() << " expressions, " << evaluations << " evaluations" << std::endl;
+    std::cout << "tree     " << tree / evaluations * 1e9 << " ns/evaluation (sum " << tree_sum << ")" << std::endl;
+    std::cout << "bytecode " << bytecode / evaluations * 1e9 << " ns/evaluation (sum " << code_sum << ")" << std::endl;
+    std::cout << "speedup  " << tree / bytecode << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <Parser.h>
+#include <Simulator.h>
+
+static void generate(const std::string& filename, std::size_t nq, std::size_t gates) {
+
+    static const char* single[] = {"h", "s", "sdg", "x", "y", "z"};
+
+    std::mt19937_64 random(nq);
+    std::ofstream out(filename);
+    out << "OPENQASM 2.0;\n";
+    out << "gate h a { U(pi/2, 0, pi) a; }\n";
+    out << "gate s a { U(0, 0, pi/2) a; }\n";
+    out << "gate sdg a { U(0, 0, -pi/2) a; }\n";
+    out << "gate x a { U(pi, 0, pi) a; }\n";
+    out << "gate y a { U(pi, pi/2, pi/2) a; }\n";
+    out << "gate z a { U(0, 0, pi) a; }\n";
+    out << "gate cx a, b { CX a, b; }\n";
+    out << "gate cz a, b { h b; cx a, b; h b; }\n";
+    out << "qreg q[" << nq << "];\n";
+    out << "creg c[" << nq << "];\n";
+    for (std::size_t i = 0; i < gates; i++) {
+        std::size_t a = random() % nq;
+        std::size_t b = (a + 1 + random() % (nq - 1)) % nq;
+        std::size_t k = random() % 8;
+        if (k < 6) out << single[k] << " q[" << a << "];\n";
+        else out << (k == 6 ? "cx" : "cz") << " q[" << a << "], q[" << b << "];\n";
+    }
+    out << "measure q -> c;\n";
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t nq = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    std::size_t gates = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10 * nq;
+    std::size_t shots = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100;
+
+    std::string filename = "bench_clifford.qasm";
+    generate(filename, nq, gates);
+    kazm::Parser parser;
+    parser.parse(filename);
+    std::remove(filename.c_str());
+
+    std::cout << "qubits gates shots mode seconds" << std::endl;
+    for (bool sampling : {true, false}) {
+        kazm::Simulator simulator(parser.program, parser.qubit_space, parser.clbit_space);
+        simulator.backend = kazm::backend_stabilizer;
+        simulator.sampling = sampling;
+        simulator.run(shots);
+        std::cout << nq << " " << gates << " " << shots << " " << (sampling ? "sampled" : "per-shot") << " " << simulator.run_time << std::endl;
+    }
+
+    return 0;
+}
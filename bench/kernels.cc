@@ -0,0 +1,36 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <StateVector.h>
+#include <Kernels.h>
+
+int main(int argc, char* argv[]) {
+
+    std::size_t nq = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 24;
+    std::size_t reps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    std::cout << "kernel gate target amplitudes/s" << std::endl;
+    for (int k = kazm::kernel_scalar; k <= kazm::Kernels::Detect(); k++) {
+        kazm::StateVector state(nq, 0);
+        state.kernel = static_cast<kazm::KernelType>(k);
+        std::string name = kazm::Kernels::GetName(state.kernel);
+
+        for (std::size_t q = 0; q < nq; q++) {
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < reps; i++) state.u(q, 0.3, 0.2, 0.1);
+            double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << name << " u " << q << " " << reps * state.size / time << std::endl;
+        }
+
+        for (std::size_t q = 0; q < nq; q++) {
+            std::size_t c = (q + 1) % nq;
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < reps; i++) state.cx(c, q);
+            double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << name << " cx " << q << " " << reps * state.size / time << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <Parser.h>
+
+static std::size_t generate(const std::string& filename, std::size_t calls) {
+
+    std::ofstream out(filename);
+    out << "OPENQASM 2.0;\n";
+    out << "gate g(a) x, y { U(a, 0, pi/2) x; CX x, y; }\n";
+    out << "qreg q[16];\n";
+    out << "creg c[16];\n";
+    for (std::size_t i = 0; i < calls; i++) out << "g(" << (i % 97) * 0.01 << ") q[" << i % 16 << "], q[" << (i + 1 + i / 16 % 15) % 16 << "];\n";
+    return out.tellp();
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t largest = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string filename = "bench_parse.qasm";
+
+    std::cout << "calls bytes seconds ns/call" << std::endl;
+    for (std::size_t calls = 10000; calls <= largest; calls *= 10) {
+        std::size_t bytes = generate(filename, calls);
+        kazm::Parser parser;
+        auto start = std::chrono::steady_clock::now();
+        parser.parse(filename);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << calls << " " << bytes << " " << time << " " << time / calls * 1e9 << std::endl;
+    }
+    std::remove(filename.c_str());
+
+    return 0;
+}
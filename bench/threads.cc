@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Parser.h>
+#include <Simulator.h>
+
+static void generate(const std::string& filename, std::size_t nq, std::size_t gates) {
+
+    std::mt19937_64 random(nq);
+    std::ofstream out(filename);
+    out << "OPENQASM 2.0;\n";
+    out << "qreg q[" << nq << "];\n";
+    for (std::size_t i = 0; i < gates; i++) {
+        std::size_t a = random() % nq;
+        std::size_t b = (a + 1 + random() % (nq - 1)) % nq;
+        if (random() % 3 == 0) out << "CX q[" << a << "], q[" << b << "];\n";
+        else out << "U(" << random() % 628 * 0.01 << ", " << random() % 628 * 0.01 << ", " << random() % 628 * 0.01 << ") q[" << a << "];\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t gates = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    std::vector<std::size_t> sizes;
+    for (int i = 2; i < argc; i++) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {20, 26, 30};
+
+    std::size_t cores = std::thread::hardware_concurrency();
+    std::vector<std::size_t> threads;
+    for (std::size_t t = 1; t < cores; t *= 2) threads.push_back(t);
+    threads.push_back(cores == 0 ? 1 : cores);
+
+    std::string filename = "bench_threads.qasm";
+    std::cout << "qubits threads seconds speedup" << std::endl;
+    for (std::size_t nq : sizes) {
+        generate(filename, nq, gates);
+        kazm::Parser parser;
+        parser.parse(filename);
+        double base = 0;
+        for (std::size_t t : threads) {
+            kazm::Simulator simulator(parser.program, parser.qubit_space, parser.clbit_space);
+            simulator.threads = t;
+            simulator.run(1);
+            if (t == 1) base = simulator.run_time;
+            std::cout << nq << " " << t << " " << simulator.run_time << " " << base / simulator.run_time << std::endl;
+        }
+    }
+    std::remove(filename.c_str());
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+
+namespace kazm {
+
+    struct Arena {
+
+        private:
+            struct Finalizer {
+                void (*destroy)(void*);
+                void* object;
+                Finalizer* next;
+            };
+
+            std::vector<char*> _blocks;
+            char* _cursor;
+            std::size_t _left;
+            std::size_t _block_size;
+            Finalizer* _finalizers;
+
+            template<class T>
+            static void Destroy(void* p) {
+                static_cast<T*>(p)->~T();
+            }
+
+        public:
+            std::size_t objects;
+            std::size_t bytes;
+
+            Arena(std::size_t = 1 << 16);
+            ~Arena();
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            void* allocate(std::size_t, std::size_t);
+
+            template<class T, class... Args>
+            T* make(Args&&... args) {
+                T* t = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                if (!std::is_trivially_destructible<T>::value) {
+                    Finalizer* f = new (allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer{&Destroy<T>, t, _finalizers};
+                    _finalizers = f;
+                }
+                objects++;
+                return t;
+            }
+
+    };
+
+}
+
+#endif
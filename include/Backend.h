@@ -0,0 +1,58 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <vector>
+#include <complex>
+#include <random>
+#include <cstdint>
+
+#include <BigInt.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct Instruction;
+
+    struct Frame {
+
+        std::vector<double> args;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> qubits;
+
+    };
+
+    struct Backend {
+
+        std::size_t nqubits;
+        std::size_t nclbits;
+        std::vector<uint64_t> clbits;
+        std::mt19937_64 rng;
+        const std::vector<double>* parameters;
+        Frame frame;
+
+        Backend(std::size_t, std::size_t);
+
+        virtual ~Backend() = default;
+
+        virtual void init();
+        virtual void u(std::size_t, double, double, double) = 0;
+        virtual void cx(std::size_t, std::size_t) = 0;
+        virtual void measure(std::size_t, std::size_t) = 0;
+        virtual void reset(std::size_t) = 0;
+        virtual void barrier(const std::vector<std::size_t>&);
+        virtual void unitary(const std::vector<std::size_t>&, const std::vector<std::complex<double> >&);
+        virtual bool beginConditional(std::size_t, std::size_t, const BigInt&);
+        virtual void endConditional();
+
+        bool check(std::size_t, std::size_t, const BigInt&) const;
+        bool getClbit(std::size_t) const;
+        void setClbit(std::size_t, bool);
+
+        void seed(uint64_t);
+        double random();
+
+    };
+
+}
+
+#endif
@@ -1,6 +1,9 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
 #include <string>
 #include <vector>
-#include <utility>
+#include <cstdint>
 
 namespace kazm {
 
@@ -11,10 +14,13 @@ namespace kazm {
         
         BigInt(const std::string&);
         
-        std::pair<char, char> divideByTwo(const std::pair<char, char>&);
+        void multiplyAdd(uint64_t, uint64_t);
         void setBit(std::size_t);
-        bool getBit(std::size_t);
+        bool getBit(std::size_t) const;
+        bool equals(const uint64_t*, std::size_t, std::size_t) const;
 
     };
 
 }
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include <Arena.h>
+#include <Expression.h>
+#include <Program.h>
+#include <Gate.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    enum ExpressionTag {
+        tag_constant,
+        tag_parameter,
+        tag_unary,
+        tag_binary
+    };
+
+    struct BinaryWriter {
+
+        std::string data;
+
+        void word(uint64_t);
+        void number(double);
+        void text(const std::string&);
+        void expression(Expression*) throw (Exception);
+        void gate(const Gate&) throw (Exception);
+
+    };
+
+    struct BinaryReader {
+
+        private:
+            std::size_t _depth;
+
+            Expression* node(Arena&, Program&);
+
+        public:
+            static const std::size_t max_depth = 10000;
+
+            const char* data;
+            std::size_t size;
+            std::size_t pos;
+
+            BinaryReader(const char*, std::size_t);
+
+            uint64_t word() throw (Exception);
+            uint64_t count() throw (Exception);
+            double number() throw (Exception);
+            std::string text() throw (Exception);
+            Expression* expression(Arena&, Program&);
+            Gate* gate(Arena&, const std::function<Gate*(const std::string&)>&);
+
+    };
+
+}
+
+#endif
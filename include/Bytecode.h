@@ -0,0 +1,57 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace kazm {
+
+    enum OpCode {
+
+        opcode_constant,
+        opcode_parameter,
+        opcode_negate,
+        opcode_sin,
+        opcode_cos,
+        opcode_tan,
+        opcode_exp,
+        opcode_ln,
+        opcode_sqrt,
+        opcode_add,
+        opcode_subtract,
+        opcode_multiply,
+        opcode_divide,
+        opcode_raise
+
+    };
+
+    struct ByteOp {
+
+        OpCode code;
+        std::size_t index;
+        double value;
+
+    };
+
+    struct Bytecode {
+
+        std::vector<ByteOp> ops;
+        std::size_t depth;
+        std::size_t max_depth;
+
+        Bytecode();
+
+        void constant(double);
+        void parameter(std::size_t);
+        void unary(OpCode);
+        void binary(OpCode);
+
+        bool isConstant() const;
+        double evaluate(const double*) const;
+        double evaluate(const double*, double*) const;
+
+    };
+
+}
+
+#endif
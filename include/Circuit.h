@@ -0,0 +1,82 @@
+#ifndef CIRCUIT_H
+#define CIRCUIT_H
+
+#include <vector>
+#include <complex>
+
+#include <Backend.h>
+#include <BigInt.h>
+
+namespace kazm {
+
+    enum OperationType {
+
+        operation_u,
+        operation_cx,
+        operation_unitary,
+        operation_measure,
+        operation_reset,
+        operation_barrier
+
+    };
+
+    struct Operation {
+
+        OperationType type;
+        std::vector<std::size_t> qubits;
+        std::vector<double> params;
+        std::vector<std::complex<double> > matrix;
+        std::size_t clbit;
+        std::size_t condition;
+
+        Operation(OperationType, const std::vector<std::size_t>&, std::size_t);
+
+        bool isUnitary() const;
+
+    };
+
+    struct Condition {
+
+        std::size_t offset;
+        std::size_t size;
+        BigInt value;
+
+        Condition(std::size_t, std::size_t, const BigInt&);
+
+    };
+
+    struct Circuit {
+
+        std::size_t qubit_space;
+        std::size_t clbit_space;
+        std::vector<Operation> operations;
+        std::vector<Condition> conditions;
+
+        Circuit(std::size_t, std::size_t);
+
+        std::size_t passes() const;
+        bool terminal(std::size_t&) const;
+        void run(Backend&) const;
+
+    };
+
+    struct Recorder : public Backend {
+
+        Circuit* circuit;
+        std::size_t condition;
+
+        Recorder(Circuit&);
+
+        void u(std::size_t, double, double, double) override;
+        void cx(std::size_t, std::size_t) override;
+        void measure(std::size_t, std::size_t) override;
+        void reset(std::size_t) override;
+        void barrier(const std::vector<std::size_t>&) override;
+        bool beginConditional(std::size_t, std::size_t, const BigInt&) override;
+        void endConditional() override;
+
+    };
+
+}
+
+#endif
@@ -11,11 +11,19 @@ namespace kazm {
     struct Constant : public Expression {
 
         std::string value;
+        double number;
+        bool valid;
 
         Constant(const std::string&);
+        Constant(const std::string&, double);
 
         std::string str() override;
         double evaluate() throw (Exception) override;
+        Expression* substitute(Arena&, const std::vector<Expression*>&) override;
+        bool isConstant() override;
+        void compile(Bytecode&) override;
+
+        static Expression* Fold(Arena&, Expression*);
 
     };
 
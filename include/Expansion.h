@@ -0,0 +1,67 @@
+#ifndef EXPANSION_H
+#define EXPANSION_H
+
+#include <cstddef>
+#include <iterator>
+
+#include <Program.h>
+#include <Instruction.h>
+
+namespace kazm {
+
+    struct Step {
+
+        const Instruction* inst;
+        const IfInst* guard;
+        std::size_t lane;
+        std::size_t lanes;
+
+        bool first() const;
+        bool last() const;
+        void execute(Backend&) const;
+
+    };
+
+    struct Expansion {
+
+        struct iterator {
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Step value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Step* pointer;
+            typedef const Step& reference;
+
+            const Program* program;
+            std::size_t index;
+            Step step;
+
+            iterator(const Program&, std::size_t);
+
+            const Step& operator*() const;
+            const Step* operator->() const;
+            iterator& operator++();
+            bool operator==(const iterator&) const;
+            bool operator!=(const iterator&) const;
+
+            void skip();
+
+            private:
+                void load();
+
+        };
+
+        const Program* program;
+
+        Expansion(const Program&);
+
+        iterator begin() const;
+        iterator end() const;
+
+        std::size_t size() const;
+
+    };
+
+}
+
+#endif
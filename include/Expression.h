@@ -4,7 +4,10 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 
+#include <Bytecode.h>
+#include <Arena.h>
 #include <Exception.h>
 
 namespace kazm {
@@ -38,6 +41,9 @@ namespace kazm {
 
         virtual std::string str() = 0;
         virtual double evaluate() throw (Exception) = 0;
+        virtual Expression* substitute(Arena&, const std::vector<Expression*>&) = 0;
+        virtual bool isConstant() = 0;
+        virtual void compile(Bytecode&) = 0;
 
     };
 
@@ -48,12 +54,15 @@ namespace kazm {
 
         public:
             UnaryExpType op;
-            std::shared_ptr<Expression> ex;
+            Expression* ex;
 
-            UnaryExpression(UnaryExpType, const std::shared_ptr<Expression>&);
+            UnaryExpression(UnaryExpType, Expression*);
 
             std::string str() override;
             double evaluate() throw (Exception) override;
+            Expression* substitute(Arena&, const std::vector<Expression*>&) override;
+            bool isConstant() override;
+            void compile(Bytecode&) override;
 
             static UnaryExpType GetType(const std::string&);
     };
@@ -66,13 +75,16 @@ namespace kazm {
 
         public:
             BinaryExpType op;
-            std::shared_ptr<Expression> lhs;
-            std::shared_ptr<Expression> rhs;
+            Expression* lhs;
+            Expression* rhs;
             
-            BinaryExpression(BinaryExpType, const std::shared_ptr<Expression>&, const std::shared_ptr<Expression>&);
+            BinaryExpression(BinaryExpType, Expression*, Expression*);
             
             std::string str() override;
             double evaluate() throw (Exception) override;
+            Expression* substitute(Arena&, const std::vector<Expression*>&) override;
+            bool isConstant() override;
+            void compile(Bytecode&) override;
             
             static BinaryExpType GetType(const std::string&);
             static std::size_t GetPrecedence(const std::string&);
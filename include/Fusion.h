@@ -0,0 +1,41 @@
+#ifndef FUSION_H
+#define FUSION_H
+
+#include <vector>
+
+#include <Circuit.h>
+#include <Kernels.h>
+
+namespace kazm {
+
+    struct Fusion {
+
+        private:
+            struct Block {
+                std::vector<std::size_t> qubits;
+                std::vector<std::size_t> ops;
+            };
+
+            const Circuit* _input;
+            Circuit* _output;
+            std::vector<Block> _blocks;
+            std::vector<std::size_t> _owner;
+
+            void close(std::size_t);
+            void emit(const Block&);
+
+        public:
+            static const std::size_t max_width = 10;
+
+            std::size_t width;
+            KernelType kernel;
+
+            Fusion(std::size_t, KernelType);
+
+            void run(const Circuit&, Circuit&);
+
+    };
+
+}
+
+#endif
@@ -4,28 +4,83 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <list>
+#include <complex>
+#include <memory>
+#include <mutex>
 
 #include <Program.h>
+#include <Expression.h>
+#include <Bytecode.h>
+#include <Arena.h>
+#include <Backend.h>
+#include <Kernels.h>
+#include <Circuit.h>
 #include <Exception.h>
 
 namespace kazm {
 
+    struct GateOp {
+
+        OperationType type;
+        std::vector<std::size_t> qubits;
+        std::vector<Expression*> params;
+        std::vector<Bytecode> code;
+
+        GateOp(OperationType, const std::vector<std::size_t>&);
+
+    };
+
+    struct CachedUnitary {
+
+        std::vector<std::complex<double> > matrix;
+        std::list<std::vector<double> >::iterator age;
+
+    };
+
     struct Gate : public Program {
 
         std::string name;
         std::size_t nparams;
         std::size_t nqubits;
-        std::vector<std::string> param_names;
         std::vector<std::string> qubit_names;
-        std::map<std::string, std::size_t> param_map;
-        std::map<std::string, std::size_t> qubit_map;
+        std::vector<std::size_t> qubit_slots;
+        bool compiled;
+        const Gate* opaque;
+        std::vector<GateOp> body;
+        mutable std::map<std::vector<double>, CachedUnitary> unitaries;
+        mutable std::list<std::vector<double> > unitary_ages;
+        mutable std::mutex unitary_mutex;
+        Arena* arena;
 
-        Gate(const std::string&, const std::vector<std::string>& pn, const std::vector<std::string>& bn);
+        Gate(Arena&, const std::string&, const std::vector<std::string>& pn, const std::vector<std::string>& bn);
 
         virtual ~Gate() = default;
 
+        std::size_t qubit(std::size_t) const;
+        void mapQubit(std::size_t, std::size_t);
+
         virtual std::string str() override;
-        virtual void execute(const Program&, const std::vector<std::size_t>&, const std::vector<std::size_t>&) throw (Exception);
+        virtual std::string str(Operand) const override;
+        virtual void compile() throw (Exception);
+        void execute(const Program&, std::size_t, std::size_t, std::size_t, Backend&) const throw (Exception);
+        void unitary(const std::vector<double>&, KernelType, std::vector<std::complex<double> >&) const throw (Exception);
+
+    };
+
+    struct UGate : public Gate {
+
+        UGate(Arena&, const std::string&, const std::vector<std::string>& pn, const std::vector<std::string>& bn);
+
+        void compile() throw (Exception) override;
+
+    };
+
+    struct CXGate : public Gate {
+
+        CXGate(Arena&, const std::string&, const std::vector<std::string>& pn, const std::vector<std::string>& bn);
+
+        void compile() throw (Exception) override;
 
     };
 
@@ -0,0 +1,129 @@
+#ifndef IR_H
+#define IR_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#include <Arena.h>
+#include <Binary.h>
+#include <Program.h>
+#include <Gate.h>
+#include <Instruction.h>
+#include <Data.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct Parser;
+
+    struct IRSection {
+
+        uint64_t offset;
+        uint64_t count;
+
+    };
+
+    struct IRString {
+
+        uint64_t offset;
+        uint64_t size;
+
+    };
+
+    struct IRRegister {
+
+        uint64_t type;
+        uint64_t name;
+        uint64_t size;
+        uint64_t offset;
+
+    };
+
+    struct IRInstruction {
+
+        uint64_t type;
+        uint64_t a;
+        uint64_t b;
+        uint64_t c;
+
+    };
+
+    struct IRHeader {
+
+        uint64_t magic;
+        uint64_t version;
+        uint64_t qasm_major;
+        uint64_t qasm_minor;
+        uint64_t params;
+        uint64_t nparams;
+        IRSection strings;
+        IRSection text;
+        IRSection names;
+        IRSection registers;
+        IRSection gates;
+        IRSection library;
+        IRSection pstack;
+        IRSection operands;
+        IRSection instructions;
+
+    };
+
+    struct IRWriter {
+
+        std::map<std::string, uint64_t> ids;
+        std::map<const Gate*, uint64_t> indices;
+
+        std::vector<IRString> strings;
+        std::string text;
+        std::vector<uint64_t> names;
+        std::vector<IRRegister> registers;
+        std::vector<uint64_t> gates;
+        BinaryWriter library;
+        std::size_t defined;
+        std::vector<uint64_t> operands;
+        std::vector<IRInstruction> instructions;
+
+        IRWriter();
+
+        uint64_t string(const std::string&);
+        void instruction(Instruction*) throw (Exception);
+        void gate(const Gate*) throw (Exception);
+        void write(Parser&, const std::string&) throw (Exception);
+
+    };
+
+    struct IRReader {
+
+        std::string filename;
+        std::string contents;
+        const char* data;
+        std::size_t size;
+        bool mapped;
+        const IRHeader* header;
+        std::vector<Gate*> gates;
+
+        IRReader(const std::string&) throw (Exception);
+        ~IRReader();
+
+        IRReader(const IRReader&) = delete;
+        IRReader& operator=(const IRReader&) = delete;
+
+        template<class T>
+        const T* section(const IRSection& s, uint64_t first, uint64_t count) throw (Exception) {
+            if (first > s.count || count > s.count - first) throw Exception("Invalid section reference in " + filename);
+            return reinterpret_cast<const T*>(data + s.offset) + first;
+        }
+
+        std::string string(uint64_t) throw (Exception);
+        BinaryReader bytes(const IRSection&);
+        Operand operand(const Program&, uint64_t, DataType) throw (Exception);
+        Instruction* instruction(Arena&, Program&, const IRInstruction&) throw (Exception);
+        void read(Parser&) throw (Exception);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef INCLUDECACHE_H
+#define INCLUDECACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+
+#include <Gate.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct Parser;
+
+    struct Library {
+
+        std::shared_ptr<Parser> parser;
+        std::vector<Gate*> gates;
+
+    };
+
+    struct IncludeCache {
+
+        private:
+            std::mutex _mutex;
+            std::map<std::pair<std::string, uint64_t>, std::shared_ptr<Library> > _libraries;
+
+            std::shared_ptr<Library> build(const std::string&, const std::shared_ptr<std::pair<std::size_t, std::size_t> >&);
+            std::shared_ptr<Library> load(const std::string&, uint64_t);
+            void save(const Library&, const std::string&, uint64_t);
+            std::string path(const std::string&, uint64_t) const;
+
+        public:
+            std::string directory;
+            std::size_t hits;
+            std::size_t misses;
+
+            IncludeCache();
+
+            std::shared_ptr<Library> find(const std::string&, const std::shared_ptr<std::pair<std::size_t, std::size_t> >&);
+            void clear();
+
+            static IncludeCache& Shared();
+            static uint64_t Hash(const char*, std::size_t, uint64_t = 14695981039346656037ull);
+
+    };
+
+}
+
+#endif
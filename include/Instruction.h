@@ -2,11 +2,11 @@
 #define INSTRUCTION_H
 
 #include <vector>
-#include <memory>
 #include <string>
 
 #include <Program.h>
 #include <Gate.h>
+#include <Backend.h>
 #include <BigInt.h>
 
 namespace kazm {
@@ -32,63 +32,69 @@ namespace kazm {
         virtual ~Instruction() = default;
 
         virtual std::string str() = 0;
-        virtual void execute() = 0;
+        virtual std::size_t lanes() const;
+        virtual void execute(Backend&, std::size_t) const = 0;
     };
 
     struct BarrierInst : public Instruction {
 
-        std::vector<std::size_t> bits;
+        std::size_t first;
+        std::size_t count;
 
-        BarrierInst(const Program&, const std::vector<std::size_t>&);
+        BarrierInst(const Program&, std::size_t, std::size_t);
 
         std::string str() override;
-        void execute() override;
+        void execute(Backend&, std::size_t) const override;
     };
 
     struct MeasureInst : public Instruction {
 
-        std::size_t q;
-        std::size_t c;
+        Operand q;
+        Operand c;
 
-        MeasureInst(const Program&, std::size_t, std::size_t);
+        MeasureInst(const Program&, Operand, Operand);
 
         std::string str() override;
-        void execute() override;
+        std::size_t lanes() const override;
+        void execute(Backend&, std::size_t) const override;
     };
 
     struct ResetInst : public Instruction {
 
-        std::size_t q;
+        Operand q;
 
-        ResetInst(const Program&, std::size_t);
+        ResetInst(const Program&, Operand);
 
         std::string str() override;
-        void execute() override;
+        std::size_t lanes() const override;
+        void execute(Backend&, std::size_t) const override;
     };
 
     struct CallInst : public Instruction {
 
-        std::shared_ptr<Gate> gate;
-        std::vector<std::size_t> params;
-        std::vector<std::size_t> bits;
+        Gate* gate;
+        std::size_t params;
+        std::size_t bits;
 
-        CallInst(const Program&, const std::shared_ptr<Gate>&, const std::vector<std::size_t>&);
-        CallInst(const Program&, const std::shared_ptr<Gate>&, const std::vector<std::size_t>&, const std::vector<std::size_t>&);
+        CallInst(const Program&, Gate*, std::size_t, std::size_t);
 
         std::string str() override;
-        void execute() override;
+        std::size_t lanes() const override;
+        void execute(Backend&, std::size_t) const override;
     };
 
     struct IfInst : public Instruction {
 
-        std::size_t creg;
+        Operand creg;
         BigInt num;
-        std::shared_ptr<Instruction> inst;
+        Instruction* inst;
 
-        IfInst(const Program&, std::size_t, const std::string&, const std::shared_ptr<Instruction>&);        
+        IfInst(const Program&, Operand, const std::string&, Instruction*);        
 
         std::string str() override;
-        void execute() override;
+        std::size_t lanes() const override;
+        void execute(Backend&, std::size_t) const override;
+        bool enter(Backend&) const;
 
     };
 }
@@ -0,0 +1,34 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <string>
+#include <complex>
+
+#include <Exception.h>
+
+namespace kazm {
+
+    enum KernelType {
+
+        kernel_scalar,
+        kernel_avx2,
+        kernel_avx512
+
+    };
+
+    struct Kernels {
+
+        static KernelType Detect();
+        static KernelType GetType(const std::string&) throw (Exception);
+        static std::string GetName(KernelType);
+        static void UMatrix(double, double, double, double*);
+
+        static void ApplyU(KernelType, std::complex<double>*, std::size_t, const double*, std::size_t, std::size_t);
+        static void ApplyUnitary(KernelType, std::complex<double>*, std::size_t, const std::size_t*, const std::size_t*, const std::complex<double>*, std::size_t, std::size_t);
+        static void ApplyCX(KernelType, std::complex<double>*, std::size_t, std::size_t, std::size_t, std::size_t);
+
+    };
+
+}
+
+#endif
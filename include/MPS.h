@@ -0,0 +1,55 @@
+#ifndef MPS_H
+#define MPS_H
+
+#include <vector>
+#include <complex>
+#include <cstdint>
+
+#include <Backend.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct Site {
+
+        std::size_t left;
+        std::size_t right;
+        std::vector<std::complex<double> > data;
+
+    };
+
+    struct MPS : public Backend {
+
+        std::size_t bond;
+        std::size_t center;
+        std::vector<Site> sites;
+        double truncation;
+        double max_truncation;
+        std::size_t max_bond;
+
+        MPS(std::size_t, std::size_t, std::size_t);
+
+        void init() override;
+        void u(std::size_t, double, double, double) override;
+        void cx(std::size_t, std::size_t) override;
+        void measure(std::size_t, std::size_t) override;
+        void reset(std::size_t) override;
+
+        void assign(const MPS&);
+
+        void apply(std::size_t, const unsigned*, bool);
+        void move(std::size_t);
+        void flip(std::size_t);
+        bool sample(std::size_t);
+        void draw(const MPS&, std::size_t, std::vector<uint8_t>&);
+        std::size_t truncate(const std::vector<double>&, std::size_t, double&);
+
+        static void Multiply(std::size_t, std::size_t, std::size_t, const std::complex<double>*, const std::complex<double>*, std::complex<double>*);
+        static void Decompose(std::size_t, std::size_t, const std::complex<double>*, std::vector<std::complex<double> >&, std::vector<double>&, std::vector<std::complex<double> >&);
+        static void Orthogonalize(std::size_t, std::size_t, double*, double*);
+
+    };
+
+}
+
+#endif
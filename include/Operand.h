@@ -0,0 +1,44 @@
+#ifndef OPERAND_H
+#define OPERAND_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace kazm {
+
+    struct Operand {
+
+        static const unsigned index_bits = 40;
+        static const unsigned reg_bits = 23;
+        static const uint64_t max_index = (uint64_t(1) << index_bits) - 1;
+        static const uint64_t max_reg = (uint64_t(1) << reg_bits) - 1;
+
+        uint64_t word;
+
+        Operand():
+            word(0)
+        {
+        }
+
+        Operand(std::size_t reg, std::size_t index, bool broadcast):
+            word((uint64_t(broadcast) << 63) | (uint64_t(reg) << index_bits) | uint64_t(index))
+        {
+        }
+
+        std::size_t reg() const {
+            return (word >> index_bits) & max_reg;
+        }
+
+        std::size_t index() const {
+            return word & max_index;
+        }
+
+        bool broadcast() const {
+            return word >> 63;
+        }
+
+    };
+
+}
+
+#endif
@@ -1,7 +1,6 @@
 #ifndef PARAMETER_H
 #define PARAMETER_H
 
-#include <memory>
 #include <string>
 
 #include <Expression.h>
@@ -13,15 +12,20 @@ namespace kazm {
     struct Parameter : public Expression {
 
         std::string name;
-        std::shared_ptr<Expression> value;
+        std::size_t index;
+        Expression* value;
 
         Parameter();
         Parameter(const std::string&);
-        Parameter(const std::shared_ptr<Constant>&);
-        Parameter(const std::string&, const std::shared_ptr<Constant>&);
+        Parameter(const std::string&, std::size_t);
+        Parameter(Constant*);
+        Parameter(const std::string&, Constant*);
 
         std::string str() override;
         double evaluate() throw (Exception) override;
+        Expression* substitute(Arena&, const std::vector<Expression*>&) override;
+        bool isConstant() override;
+        void compile(Bytecode&) override;
 
     };
 
@@ -10,34 +10,50 @@
 #include <Exception.h>
 #include <SourceFile.h>
 #include <Token.h>
-#include <Data.h>
+#include <TokenWindow.h>
+#include <SymbolTable.h>
+#include <Arena.h>
+#include <Operand.h>
 #include <Register.h>
 #include <Gate.h>
 #include <Program.h>
+#include <IncludeCache.h>
 
 namespace kazm {
 
     struct Parser {
 	
+        Arena arena;
+
         std::vector<std::shared_ptr<SourceFile> > files;
-        std::vector<Token> tokens;
+        TokenWindow tokens;
 
         std::shared_ptr<std::pair<std::size_t, std::size_t> > qasm_version;
 
         std::size_t clbit_space;
         std::size_t qubit_space;
         
-        std::map<std::string, std::shared_ptr<Register> > cregs;
-        std::map<std::string, std::shared_ptr<Register> > qregs;
-        std::map<std::string, std::shared_ptr<Gate> > gates;
+        SymbolTable symbols;
+        std::vector<Register*> cregs;
+        std::vector<Register*> qregs;
+        std::vector<Gate*> gates;
 
         Program program;
+        bool symbolic;
+
+        IncludeCache* includes;
+        std::vector<std::string> included;
+        std::vector<std::shared_ptr<Library> > libraries;
+
+        std::size_t threads;
+        std::vector<std::shared_ptr<Parser> > chunks;
 
         Parser();
 
-        bool isQReg(const std::string&);
-        bool isCReg(const std::string&);
-        bool isGate(const std::string&);
+        bool isQReg(std::size_t);
+        bool isCReg(std::size_t);
+        bool isGate(std::size_t);
+        void define(std::size_t);
 
         std::string str();
         
@@ -48,20 +64,24 @@ namespace kazm {
         std::size_t parseHeader(std::size_t) throw (Exception);
         std::size_t parseUnit(std::size_t) throw (Exception);
         std::size_t parseInclude(std::size_t) throw (Exception);
+        bool install(const std::string&);
 
         std::size_t parseReg(std::size_t) throw (Exception);
         std::size_t parseGate(std::size_t) throw (Exception);
-        std::size_t parseQubitList(std::size_t, const Gate&, std::vector<std::size_t>&) throw (Exception);
+        std::size_t parseQubitList(std::size_t, Gate&, std::size_t&) throw (Exception);
+
+        std::size_t parseChunks(std::size_t) throw (Exception);
+        bool parseChunk(const std::string&, const char*, std::size_t);
 
         std::size_t parseProgramStatement(std::size_t) throw (Exception);
-        std::size_t parseQubitReg(std::size_t, std::shared_ptr<Data>&) throw (Exception);
-        std::size_t parseBitReg(std::size_t, std::shared_ptr<Data>&) throw (Exception);
-        std::size_t parseQubitRegList(std::size_t, std::vector<std::size_t>&) throw (Exception);
+        std::size_t parseQubitReg(std::size_t, Operand&) throw (Exception);
+        std::size_t parseBitReg(std::size_t, Operand&) throw (Exception);
+        std::size_t parseQubitRegList(std::size_t, std::size_t&) throw (Exception);
 
         std::size_t parseExpList(std::size_t, Program&, std::vector<std::size_t>&) throw (Exception);
-        std::size_t parseExp(std::size_t, Program&, std::shared_ptr<Expression>&) throw (Exception);
-        std::size_t parseUnary(std::size_t, Program&, std::shared_ptr<Expression>&) throw (Exception);
-        std::size_t parseBinaryRHS(std::size_t, Program&, const std::string&, std::shared_ptr<Expression>&) throw (Exception);
+        std::size_t parseExp(std::size_t, Program&, Expression*&) throw (Exception);
+        std::size_t parseUnary(std::size_t, Program&, Expression*&) throw (Exception);
+        std::size_t parseBinaryRHS(std::size_t, Program&, const std::string&, Expression*&) throw (Exception);
         
     };
 
@@ -1,27 +1,59 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
-#include <memory>
 #include <vector>
+#include <string>
+#include <mutex>
+
+#include <Bytecode.h>
+#include <Operand.h>
+#include <Exception.h>
 
 namespace kazm {
 
-    struct Data;
+    struct Register;
     struct Expression;
     struct Instruction;
+    struct Backend;
+    struct Circuit;
 
     struct Program {
 
-        std::vector<std::shared_ptr<Data> > bstack;
-        std::vector<std::shared_ptr<Expression> > pstack;
+        std::vector<Operand> operands;
+        std::vector<Register*> registers;
+        std::vector<std::size_t> reg_offsets;
+        std::vector<std::size_t> reg_sizes;
+        std::vector<Expression*> pstack;
+        std::vector<Bytecode> pcode;
+        std::mutex pcode_mutex;
+
+        std::vector<std::string> param_names;
+        std::vector<std::size_t> param_slots;
+        std::vector<Expression*> params;
 
-        std::vector<std::shared_ptr<Instruction> > instructions;
+        std::vector<Instruction*> instructions;
 
         virtual ~Program() = default;
 
 		virtual std::string str();
+        virtual std::string str(Operand) const;
+
+        std::size_t addRegister(Register*);
+        std::size_t offset(Operand) const;
+        std::size_t size(Operand) const;
+        std::string checkOperands(std::size_t, std::size_t) const;
+        std::string checkMeasure(Operand, Operand) const;
+
+        std::size_t param(std::size_t) const;
+        void mapParam(std::size_t, std::size_t);
+
+        void compile();
+        void bind(const std::vector<double>&, std::vector<double>&) throw (Exception);
 
-        void run();
+        void run(Backend&);
+        void run(Backend&, const std::vector<double>&) throw (Exception);
+        void flatten(Circuit&);
+        void flatten(Circuit&, const std::vector<double>&) throw (Exception);
 
     };
 
@@ -14,9 +14,10 @@ namespace kazm {
             DataType _type;
             std::size_t _size;
             std::size_t _offset;
+            std::size_t _index;
 
         public:
-            Register(DataType, const std::string&, std::size_t, std::size_t);
+            Register(DataType, const std::string&, std::size_t, std::size_t, std::size_t);
             virtual ~Register() = default;
 
             virtual std::string name() override;
@@ -25,6 +26,8 @@ namespace kazm {
             virtual std::size_t offset() throw (Exception) override;
             virtual bool isReg() throw (Exception) override;
 
+            std::size_t index();
+
             virtual std::string str();
     };
 
@@ -0,0 +1,22 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <vector>
+#include <cstddef>
+
+namespace kazm {
+
+    struct Sampler {
+
+        std::vector<double> threshold;
+        std::vector<std::size_t> alias;
+
+        Sampler(const std::vector<double>&);
+
+        std::size_t draw(double) const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+#include <Program.h>
+#include <Backend.h>
+#include <StateVector.h>
+#include <Circuit.h>
+#include <Kernels.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    enum BackendType {
+        backend_statevector,
+        backend_stabilizer,
+        backend_mps
+    };
+
+    struct Simulator {
+
+        Program* program;
+        std::size_t qubit_space;
+        std::size_t clbit_space;
+        uint64_t seed;
+        KernelType kernel;
+        std::size_t threads;
+        std::size_t fusion;
+        bool sampling;
+        BackendType backend;
+        std::size_t bond;
+
+        std::size_t passes_before;
+        std::size_t passes_after;
+        double fusion_time;
+        double run_time;
+        std::size_t max_bond;
+        double truncation;
+
+        Simulator(Program&, std::size_t, std::size_t);
+
+        std::map<std::string, std::size_t> run(std::size_t);
+        std::map<std::string, std::size_t> stabilizer(std::size_t);
+        std::map<std::string, std::size_t> mps(std::size_t);
+        std::vector<std::map<std::string, std::size_t> > sweep(const std::vector<std::vector<double> >&, std::size_t);
+
+        void check() const throw (Exception);
+        std::string outcome(const Backend&);
+
+        static BackendType GetBackend(const std::string&) throw (Exception);
+        std::map<std::string, std::size_t> sample(const std::vector<Operation>&, std::size_t, StateVector&);
+
+    };
+
+}
+
+#endif
@@ -2,22 +2,34 @@
 #define SOURCEFILE_H
 
 #include <string>
-#include <fstream>
 
 #include <Exception.h>
 #include <Scanner.h>
 #include <Token.h>
+#include <SymbolTable.h>
 
 namespace kazm {
 
     struct SourceFile {
     
         std::string filename;
-        std::ifstream file;
+        std::string contents;
+        const char* data;
+        std::size_t size;
+        std::size_t start;
+        int line;
+        bool mapped;
+        SymbolTable* symbols;
         Scanner lexer;
         
-        SourceFile(const std::string&) throw (Exception);
+        SourceFile(const std::string&, SymbolTable&) throw (Exception);
+        SourceFile(const std::string&, const char*, std::size_t, SymbolTable&);
+        ~SourceFile();
+
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
         
+        void seek(std::size_t, int);
         Token scan();
     };
 
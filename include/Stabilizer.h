@@ -0,0 +1,47 @@
+#ifndef STABILIZER_H
+#define STABILIZER_H
+
+#include <vector>
+#include <cstdint>
+
+#include <Backend.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct Stabilizer : public Backend {
+
+        std::size_t rows;
+        std::size_t words;
+        std::vector<uint64_t> x;
+        std::vector<uint64_t> z;
+        std::vector<uint8_t> r;
+
+        Stabilizer(std::size_t, std::size_t);
+
+        void init() override;
+        void u(std::size_t, double, double, double) override;
+        void cx(std::size_t, std::size_t) override;
+        void measure(std::size_t, std::size_t) override;
+        void reset(std::size_t) override;
+
+        void assign(const Stabilizer&);
+
+        void clifford(std::size_t, unsigned, unsigned, unsigned);
+        void h(std::size_t);
+        void s(std::size_t);
+        void xgate(std::size_t);
+        bool sample(std::size_t);
+
+        void rowsum(std::size_t, std::size_t);
+        void rowcopy(std::size_t, std::size_t);
+        void rowclear(std::size_t);
+
+        static bool Quarter(double, unsigned&);
+        static bool IsClifford(double, double, double);
+
+    };
+
+}
+
+#endif
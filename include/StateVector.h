@@ -0,0 +1,48 @@
+#ifndef STATEVECTOR_H
+#define STATEVECTOR_H
+
+#include <vector>
+#include <complex>
+#include <functional>
+
+#include <Backend.h>
+#include <Kernels.h>
+#include <ThreadPool.h>
+#include <Exception.h>
+
+namespace kazm {
+
+    struct StateVector : public Backend {
+
+        std::size_t size;
+        KernelType kernel;
+        ThreadPool* pool;
+        std::complex<double>* amplitudes;
+
+        StateVector(std::size_t, std::size_t, ThreadPool* = nullptr) throw (Exception);
+        ~StateVector();
+
+        StateVector(const StateVector&) = delete;
+        StateVector& operator=(const StateVector&) = delete;
+
+        void init() override;
+        void u(std::size_t, double, double, double) override;
+        void cx(std::size_t, std::size_t) override;
+        void measure(std::size_t, std::size_t) override;
+        void reset(std::size_t) override;
+        void unitary(const std::vector<std::size_t>&, const std::vector<std::complex<double> >&) override;
+
+        void x(std::size_t);
+        bool sample(std::size_t);
+        double probability(std::size_t);
+        void distribution(const std::vector<std::size_t>&, std::vector<double>&);
+        void collapse(std::size_t, bool, double);
+
+        void parallel(std::size_t, const std::function<void(std::size_t, std::size_t)>&);
+        double reduce(std::size_t, const std::function<double(std::size_t, std::size_t)>&);
+
+    };
+
+}
+
+#endif
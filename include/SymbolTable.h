@@ -0,0 +1,39 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+
+namespace kazm {
+
+    struct SymbolTable {
+
+        private:
+            std::vector<std::size_t> _slots;
+            std::vector<uint64_t> _hashes;
+            std::deque<std::string> _names;
+
+            static uint64_t Hash(const char*, std::size_t);
+            std::size_t probe(const char*, std::size_t, uint64_t) const;
+            void grow();
+
+        public:
+            static const std::size_t npos = static_cast<std::size_t>(-1);
+
+            SymbolTable();
+
+            std::size_t intern(const char*, std::size_t);
+            std::size_t intern(const std::string&);
+            std::size_t find(const std::string&) const;
+
+            const std::string& name(std::size_t) const;
+            std::size_t size() const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace kazm {
+
+    struct ThreadPool {
+
+        private:
+            std::vector<std::thread> _workers;
+            std::mutex _mutex;
+            std::condition_variable _start;
+            std::condition_variable _done;
+            const std::function<void(std::size_t)>* _task;
+            std::atomic<std::size_t> _generation;
+            std::atomic<std::size_t> _pending;
+            bool _stop;
+
+            void work(std::size_t);
+
+        public:
+            std::size_t nthreads;
+
+            ThreadPool(std::size_t);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            void run(const std::function<void(std::size_t)>&);
+
+            static void Split(std::size_t, std::size_t, std::size_t, std::size_t, std::size_t&, std::size_t&);
+
+    };
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define TOKEN_H
 
 #include <string>
+#include <cstddef>
 
 namespace kazm {
 
@@ -37,12 +38,16 @@ namespace kazm {
     struct Token {
     
         int type;
-        std::string value;
+        const char* text;
+        std::size_t size;
+        std::size_t id;
         int line;
 
         Token();
 
-        Token(int, const std::string&, int);
+        Token(int, int);
+
+        std::string str() const;
     };
 
 }
@@ -0,0 +1,29 @@
+#ifndef TOKENWINDOW_H
+#define TOKENWINDOW_H
+
+#include <deque>
+
+#include <Token.h>
+
+namespace kazm {
+
+    struct TokenWindow {
+
+        private:
+            std::deque<Token> _tokens;
+
+        public:
+            TokenWindow();
+
+            Token& operator[](std::size_t);
+            std::size_t size();
+
+            void push_back(Token&&);
+            void pop_back();
+            void release(std::size_t, std::size_t);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TRAJECTORIES_H
+#define TRAJECTORIES_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+#include <ThreadPool.h>
+
+namespace kazm {
+
+    struct Trajectories {
+
+        private:
+            struct Queue {
+                std::atomic<uint64_t> range;
+                char pad[64 - sizeof(std::atomic<uint64_t>)];
+            };
+
+            ThreadPool* _pool;
+            std::unique_ptr<Queue[]> _queues;
+
+            bool pop(std::size_t, std::size_t&);
+            bool steal(std::size_t, std::size_t&);
+
+        public:
+            std::size_t grain;
+
+            Trajectories(ThreadPool&, std::size_t);
+
+            void run(std::size_t, const std::function<void(std::size_t, std::size_t, std::size_t)>&);
+
+            static uint64_t Seed(uint64_t, std::size_t);
+
+    };
+
+}
+
+#endif
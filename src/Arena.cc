@@ -0,0 +1,42 @@
+#include <cstdlib>
+
+#include <Arena.h>
+
+namespace kazm {
+
+    Arena::Arena(std::size_t b):
+        _cursor(nullptr),
+        _left(0),
+        _block_size(b),
+        _finalizers(nullptr),
+        objects(0),
+        bytes(0)
+    {
+    }
+
+    Arena::~Arena() {
+        for (Finalizer* f = _finalizers; f != nullptr; f = f->next) f->destroy(f->object);
+        for (std::size_t i = 0; i < _blocks.size(); i++) free(_blocks[i]);
+    }
+
+    void* Arena::allocate(std::size_t size, std::size_t align) {
+
+        std::size_t pad = (align - reinterpret_cast<std::size_t>(_cursor) % align) % align;
+        if (_cursor == nullptr || pad + size > _left) {
+            std::size_t n = size + align > _block_size ? size + align : _block_size;
+            char* block = static_cast<char*>(malloc(n));
+            if (block == nullptr) throw std::bad_alloc();
+            _blocks.push_back(block);
+            _cursor = block;
+            _left = n;
+            pad = (align - reinterpret_cast<std::size_t>(_cursor) % align) % align;
+        }
+
+        void* p = _cursor + pad;
+        _cursor += pad + size;
+        _left -= pad + size;
+        bytes += size;
+        return p;
+    }
+
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+
+#include <Backend.h>
+#include <Instruction.h>
+
+namespace kazm {
+
+    Backend::Backend(std::size_t nq, std::size_t nc):
+        nqubits(nq),
+        nclbits(nc),
+        clbits((nc + 63) / 64, 0),
+        parameters(nullptr)
+    {
+    }
+
+    void Backend::init() {
+        std::fill(clbits.begin(), clbits.end(), 0);
+    }
+
+    void Backend::barrier(const std::vector<std::size_t>&) {
+    }
+
+    void Backend::unitary(const std::vector<std::size_t>&, const std::vector<std::complex<double> >&) {
+        throw Exception("<Internal error Backend::unitary()> Dense unitaries are not supported by this backend");
+    }
+
+    bool Backend::beginConditional(std::size_t offset, std::size_t size, const BigInt& num) {
+        return check(offset, size, num);
+    }
+
+    void Backend::endConditional() {
+    }
+
+    bool Backend::check(std::size_t offset, std::size_t size, const BigInt& num) const {
+        return num.equals(clbits.data(), offset, size);
+    }
+
+    bool Backend::getClbit(std::size_t c) const {
+        return (clbits[c/64] >> (c%64)) & 1;
+    }
+
+    void Backend::setClbit(std::size_t c, bool value) {
+        uint64_t mask = uint64_t(1) << (c%64);
+        clbits[c/64] = value ? (clbits[c/64] | mask) : (clbits[c/64] & ~mask);
+    }
+
+    void Backend::seed(uint64_t s) {
+        rng.seed(s);
+    }
+
+    double Backend::random() {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    }
+
+}
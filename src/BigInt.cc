@@ -2,30 +2,24 @@
 
 namespace kazm {
 
-    std::pair<char, char> BigInt::divideByTwo(const std::pair<char, char>& n) {
-
-        if (n.first == '0' && n.second == '0') return std::pair<char, char>('0', '0');
-        if (n.first == '0' && n.second == '1') return std::pair<char, char>('0', '1');
-        if (n.first == '0' && n.second == '2') return std::pair<char, char>('1', '0');
-        if (n.first == '0' && n.second == '3') return std::pair<char, char>('1', '1');
-        if (n.first == '0' && n.second == '4') return std::pair<char, char>('2', '0');
-        if (n.first == '0' && n.second == '5') return std::pair<char, char>('2', '1');
-        if (n.first == '0' && n.second == '6') return std::pair<char, char>('3', '0');
-        if (n.first == '0' && n.second == '7') return std::pair<char, char>('3', '1');
-        if (n.first == '0' && n.second == '8') return std::pair<char, char>('4', '0');
-        if (n.first == '0' && n.second == '9') return std::pair<char, char>('4', '1');
-        if (n.first == '1' && n.second == '0') return std::pair<char, char>('5', '0');
-        if (n.first == '1' && n.second == '1') return std::pair<char, char>('5', '1');
-        if (n.first == '1' && n.second == '2') return std::pair<char, char>('6', '0');
-        if (n.first == '1' && n.second == '3') return std::pair<char, char>('6', '1');
-        if (n.first == '1' && n.second == '4') return std::pair<char, char>('7', '0');
-        if (n.first == '1' && n.second == '5') return std::pair<char, char>('7', '1');
-        if (n.first == '1' && n.second == '6') return std::pair<char, char>('8', '0');
-        if (n.first == '1' && n.second == '7') return std::pair<char, char>('8', '1');
-        if (n.first == '1' && n.second == '8') return std::pair<char, char>('9', '0');
-        if (n.first == '1' && n.second == '9') return std::pair<char, char>('9', '1');
-        
-        return std::pair<char, char>('0', '0');
+    static const std::size_t chunk_digits = 18;
+    static const uint64_t chunk_powers[chunk_digits+1] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+        1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+        1000000000000000000ULL
+    };
+
+    void BigInt::multiplyAdd(uint64_t m, uint64_t a) {
+
+        uint64_t carry = a;
+        for (std::size_t i = 0; i < num.size(); i++) {
+            unsigned __int128 p = static_cast<unsigned __int128>(num[i]) * m + carry;
+            num[i] = static_cast<uint64_t>(p);
+            carry = static_cast<uint64_t>(p >> 64);
+        }
+        if (carry) num.push_back(carry);
+
     }
 
     void BigInt::setBit(std::size_t b) {
@@ -34,39 +28,54 @@ namespace kazm {
         std::size_t pos = b%64;
         
         while(idx >= num.size()) num.push_back(0);
-        num[idx] |= (1 << pos);
+        num[idx] |= (uint64_t(1) << pos);
 
     }
 
-    bool BigInt::getBit(std::size_t b) {
+    bool BigInt::getBit(std::size_t b) const {
 
         std::size_t idx = b/64;
         std::size_t pos = b%64;
 
-        while(idx >= num.size()) num.push_back(0);
-        return ( (num[idx] & (1 << pos)) != 0);
+        if (idx >= num.size()) return false;
+        return ( (num[idx] & (uint64_t(1) << pos)) != 0);
+
+    }
+
+    bool BigInt::equals(const uint64_t* words, std::size_t offset, std::size_t size) const {
+
+        std::size_t nwords = (size + 63) / 64;
+        if (num.size() > nwords) return false;
+
+        for (std::size_t w = 0; w < nwords; w++) {
+            std::size_t n = size - 64*w < 64 ? size - 64*w : 64;
+            std::size_t pos = offset + 64*w;
+            std::size_t q = pos / 64;
+            std::size_t r = pos % 64;
+            uint64_t v = words[q] >> r;
+            if (r && r + n > 64) v |= words[q+1] << (64 - r);
+            uint64_t mask = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+            uint64_t expected = w < num.size() ? num[w] : 0;
+            if (expected & ~mask) return false;
+            if ((v & mask) != expected) return false;
+        }
+
+        return true;
 
     }
 
     BigInt::BigInt(const std::string& s): 
         str(s)
     {
-        std::string dividend = str;
-        std::size_t bit = 0;
-        
-        while (dividend != "0") {
-            std::string division = "";
-            char carry = '0';
-            for (std::size_t i = 0; i < dividend.length(); i++) {
-                auto result = divideByTwo(std::pair<char, char>(carry, dividend[i]));
-                division += result.first;
-                carry = result.second;
-            }
-            if (carry == '1') setBit(bit);
-            bit++;
-            dividend = division;
-            if (dividend.size() > 1 && dividend[0] == '0') dividend = dividend.substr(1);
+        std::size_t i = 0;
+        while (i < str.size()) {
+            std::size_t n = str.size() - i < chunk_digits ? str.size() - i : chunk_digits;
+            uint64_t chunk = 0;
+            for (std::size_t j = 0; j < n; j++) chunk = chunk * 10 + (str[i+j] - '0');
+            multiplyAdd(chunk_powers[n], chunk);
+            i += n;
         }
+        while (!num.empty() && num.back() == 0) num.pop_back();
     }
 
 }
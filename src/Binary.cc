@@ -0,0 +1,233 @@
+#include <cstring>
+
+#include <Binary.h>
+#include <Constant.h>
+#include <Parameter.h>
+#include <Instruction.h>
+
+namespace kazm {
+
+    void BinaryWriter::word(uint64_t w) {
+        char buf[sizeof(w)];
+        std::memcpy(buf, &w, sizeof(w));
+        data.append(buf, sizeof(w));
+    }
+
+    void BinaryWriter::number(double d) {
+        uint64_t w;
+        std::memcpy(&w, &d, sizeof(w));
+        word(w);
+    }
+
+    void BinaryWriter::text(const std::string& s) {
+        word(s.size());
+        data.append(s);
+        data.append((8 - s.size() % 8) % 8, '\0');
+    }
+
+    void BinaryWriter::expression(Expression* e) throw (Exception) {
+        if (auto c = dynamic_cast<Constant*>(e)) {
+            word(tag_constant);
+            text(c->value);
+            number(c->number);
+            word(c->valid);
+        }
+        else if (auto p = dynamic_cast<Parameter*>(e)) {
+            word(tag_parameter);
+            text(p->name);
+            word(p->index);
+            word(p->value != nullptr);
+            if (p->value) expression(p->value);
+        }
+        else if (auto u = dynamic_cast<UnaryExpression*>(e)) {
+            word(tag_unary);
+            word(u->op);
+            expression(u->ex);
+        }
+        else if (auto b = dynamic_cast<BinaryExpression*>(e)) {
+            word(tag_binary);
+            word(b->op);
+            expression(b->lhs);
+            expression(b->rhs);
+        }
+        else throw Exception("<Internal error BinaryWriter::expression()> Unknown expression type");
+    }
+
+    void BinaryWriter::gate(const Gate& g) throw (Exception) {
+
+        text(g.name);
+        word(g.param_names.size());
+        for (const std::string& s : g.param_names) text(s);
+        word(g.qubit_names.size());
+        for (const std::string& s : g.qubit_names) text(s);
+        word(g.opaque == &g);
+
+        word(g.pstack.size() - g.nparams);
+        for (std::size_t i = g.nparams; i < g.pstack.size(); i++) expression(g.pstack[i]);
+
+        word(g.operands.size());
+        for (Operand op : g.operands) word(op.word);
+
+        word(g.instructions.size());
+        for (Instruction* inst : g.instructions) {
+            word(inst->type);
+            if (inst->type == instruction_barrier) {
+                auto barrier = dynamic_cast<BarrierInst*>(inst);
+                word(barrier->first);
+                word(barrier->count);
+            }
+            else if (inst->type == instruction_call) {
+                auto call = dynamic_cast<CallInst*>(inst);
+                text(call->gate->name);
+                word(call->params);
+                word(call->bits);
+            }
+            else throw Exception("<Internal error BinaryWriter::gate()> Unexpected instruction in body of gate " + g.name);
+        }
+    }
+
+    BinaryReader::BinaryReader(const char* d, std::size_t s):
+        _depth(0),
+        data(d),
+        size(s),
+        pos(0)
+    {
+    }
+
+    uint64_t BinaryReader::word() throw (Exception) {
+        if (size - pos < sizeof(uint64_t)) throw Exception("Unexpected end of binary data");
+        uint64_t w;
+        std::memcpy(&w, data + pos, sizeof(w));
+        pos += sizeof(w);
+        return w;
+    }
+
+    uint64_t BinaryReader::count() throw (Exception) {
+        uint64_t n = word();
+        if (n > (size - pos) / sizeof(uint64_t)) throw Exception("Invalid count in binary data");
+        return n;
+    }
+
+    double BinaryReader::number() throw (Exception) {
+        uint64_t w = word();
+        double d;
+        std::memcpy(&d, &w, sizeof(d));
+        return d;
+    }
+
+    std::string BinaryReader::text() throw (Exception) {
+        uint64_t n = word();
+        uint64_t padded = n + (8 - n % 8) % 8;
+        if (n > size - pos || padded > size - pos) throw Exception("Unexpected end of binary data");
+        std::string s(data + pos, n);
+        pos += padded;
+        return s;
+    }
+
+    Expression* BinaryReader::expression(Arena& arena, Program& prog) {
+        if (_depth == max_depth) throw Exception("Expression nested too deeply in binary data");
+        _depth++;
+        Expression* e = node(arena, prog);
+        _depth--;
+        return e;
+    }
+
+    Expression* BinaryReader::node(Arena& arena, Program& prog) {
+
+        uint64_t tag = word();
+
+        if (tag == tag_constant) {
+            std::string value = text();
+            double d = number();
+            bool valid = word();
+            auto c = arena.make<Constant>(value, d);
+            c->valid = valid;
+            return c;
+        }
+        else if (tag == tag_parameter) {
+            std::string name = text();
+            uint64_t index = word();
+            if (!word()) {
+                if (index >= prog.params.size()) throw Exception("Invalid parameter index in binary data");
+                auto p = dynamic_cast<Parameter*>(prog.params[index]);
+                if (p && p->name == name) return p;
+                return arena.make<Parameter>(name, index);
+            }
+            auto c = dynamic_cast<Constant*>(expression(arena, prog));
+            if (!c) throw Exception("Invalid parameter value in binary data");
+            auto p = arena.make<Parameter>(name, c);
+            p->index = index;
+            return p;
+        }
+        else if (tag == tag_unary) {
+            uint64_t op = word();
+            if (op > unaryop_sqrt) throw Exception("Invalid unary operator in binary data");
+            return arena.make<UnaryExpression>(static_cast<UnaryExpType>(op), expression(arena, prog));
+        }
+        else if (tag == tag_binary) {
+            uint64_t op = word();
+            if (op > binaryop_raise) throw Exception("Invalid binary operator in binary data");
+            Expression* lhs = expression(arena, prog);
+            Expression* rhs = expression(arena, prog);
+            return arena.make<BinaryExpression>(static_cast<BinaryExpType>(op), lhs, rhs);
+        }
+
+        throw Exception("Invalid expression in binary data");
+    }
+
+    Gate* BinaryReader::gate(Arena& arena, const std::function<Gate*(const std::string&)>& resolve) {
+
+        std::string name = text();
+        std::vector<std::string> pn(count());
+        for (std::string& s : pn) s = text();
+        std::vector<std::string> bn(count());
+        for (std::string& s : bn) s = text();
+        if (bn.empty()) throw Exception("Gate " + name + " has no qubits in binary data");
+        bool opaque = word() != 0;
+
+        auto g = arena.make<Gate>(arena, name, pn, bn);
+        if (opaque) g->opaque = g;
+
+        uint64_t np = count();
+        for (uint64_t i = 0; i < np; i++) g->pstack.push_back(expression(arena, *g));
+
+        uint64_t nb = count();
+        for (uint64_t i = 0; i < nb; i++) {
+            Operand op;
+            op.word = word();
+            if (op.broadcast() || op.index() != 0 || op.reg() >= g->nqubits) throw Exception("Invalid qubit in body of gate " + name + " in binary data");
+            g->operands.push_back(op);
+        }
+
+        uint64_t ni = count();
+        for (uint64_t i = 0; i < ni; i++) {
+            uint64_t type = word();
+            if (type == instruction_barrier) {
+                uint64_t first = word();
+                uint64_t count = word();
+                if (first > g->operands.size() || count > g->operands.size() - first) throw Exception("Invalid barrier in body of gate " + name + " in binary data");
+                g->instructions.push_back(arena.make<BarrierInst>(*g, first, count));
+            }
+            else if (type == instruction_call) {
+                std::string callee = text();
+                uint64_t params = word();
+                uint64_t bits = word();
+                Gate* target = resolve(callee);
+                if (!target) throw Exception("Unknown gate " + callee + " in body of gate " + name + " in binary data");
+                if (params > g->pstack.size() || target->nparams > g->pstack.size() - params) throw Exception("Invalid parameters in body of gate " + name + " in binary data");
+                if (bits > g->operands.size() || target->nqubits > g->operands.size() - bits) throw Exception("Invalid qubits in body of gate " + name + " in binary data");
+                for (uint64_t j = bits; j < bits + target->nqubits; j++) {
+                    for (uint64_t k = j + 1; k < bits + target->nqubits; k++) {
+                        if (g->operands[j].word == g->operands[k].word) throw Exception("Repeated qubit in body of gate " + name + " in binary data");
+                    }
+                }
+                g->instructions.push_back(arena.make<CallInst>(*g, target, params, bits));
+            }
+            else throw Exception("Invalid instruction in body of gate " + name + " in binary data");
+        }
+
+        g->compile();
+        return g;
+    }
+
+}
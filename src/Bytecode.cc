@@ -0,0 +1,71 @@
+#include <cmath>
+
+#include <Bytecode.h>
+
+namespace kazm {
+
+    Bytecode::Bytecode():
+        depth(0),
+        max_depth(0)
+    {
+    }
+
+    void Bytecode::constant(double v) {
+        ops.push_back({opcode_constant, 0, v});
+        depth++;
+        if (depth > max_depth) max_depth = depth;
+    }
+
+    void Bytecode::parameter(std::size_t i) {
+        ops.push_back({opcode_parameter, i, 0.0});
+        depth++;
+        if (depth > max_depth) max_depth = depth;
+    }
+
+    void Bytecode::unary(OpCode c) {
+        ops.push_back({c, 0, 0.0});
+    }
+
+    void Bytecode::binary(OpCode c) {
+        ops.push_back({c, 0, 0.0});
+        depth--;
+    }
+
+    bool Bytecode::isConstant() const {
+        return ops.size() == 1 && ops[0].code == opcode_constant;
+    }
+
+    double Bytecode::evaluate(const double* a) const {
+        if (isConstant()) return ops[0].value;
+        if (max_depth <= 16) {
+            double stack[16];
+            return evaluate(a, stack);
+        }
+        std::vector<double> stack(max_depth);
+        return evaluate(a, stack.data());
+    }
+
+    double Bytecode::evaluate(const double* a, double* stack) const {
+        std::size_t sp = 0;
+        for (const ByteOp& op : ops) {
+            switch (op.code) {
+                case opcode_constant: stack[sp++] = op.value; break;
+                case opcode_parameter: stack[sp++] = a[op.index]; break;
+                case opcode_negate: stack[sp-1] = -stack[sp-1]; break;
+                case opcode_sin: stack[sp-1] = sin(stack[sp-1]); break;
+                case opcode_cos: stack[sp-1] = cos(stack[sp-1]); break;
+                case opcode_tan: stack[sp-1] = tan(stack[sp-1]); break;
+                case opcode_exp: stack[sp-1] = exp(stack[sp-1]); break;
+                case opcode_ln: stack[sp-1] = log(stack[sp-1]); break;
+                case opcode_sqrt: stack[sp-1] = sqrt(stack[sp-1]); break;
+                case opcode_add: sp--; stack[sp-1] = stack[sp-1] + stack[sp]; break;
+                case opcode_subtract: sp--; stack[sp-1] = stack[sp-1] - stack[sp]; break;
+                case opcode_multiply: sp--; stack[sp-1] = stack[sp-1] * stack[sp]; break;
+                case opcode_divide: sp--; stack[sp-1] = stack[sp-1] / stack[sp]; break;
+                case opcode_raise: sp--; stack[sp-1] = pow(stack[sp-1], stack[sp]); break;
+            }
+        }
+        return stack[0];
+    }
+
+}
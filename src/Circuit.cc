@@ -0,0 +1,119 @@
+#include <Circuit.h>
+#include <Instruction.h>
+
+namespace kazm {
+
+    Operation::Operation(OperationType t, const std::vector<std::size_t>& q, std::size_t c):
+        type(t),
+        qubits(q),
+        clbit(0),
+        condition(c)
+    {
+    }
+
+    bool Operation::isUnitary() const {
+        return type == operation_u || type == operation_cx || type == operation_unitary;
+    }
+
+    Condition::Condition(std::size_t o, std::size_t s, const BigInt& v):
+        offset(o),
+        size(s),
+        value(v)
+    {
+    }
+
+    Circuit::Circuit(std::size_t nq, std::size_t nc):
+        qubit_space(nq),
+        clbit_space(nc)
+    {
+    }
+
+    std::size_t Circuit::passes() const {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < operations.size(); i++) {
+            if (operations[i].isUnitary()) n++;
+        }
+        return n;
+    }
+
+    bool Circuit::terminal(std::size_t& first) const {
+
+        first = operations.size();
+
+        for (std::size_t i = 0; i < operations.size(); i++) {
+            const Operation& op = operations[i];
+            if (op.type == operation_reset) return false;
+            if (op.type == operation_measure) {
+                if (op.condition != 0) return false;
+                if (first == operations.size()) first = i;
+            }
+            else if (first != operations.size() && op.type != operation_barrier) return false;
+        }
+
+        return true;
+    }
+
+    void Circuit::run(Backend& backend) const {
+
+        std::size_t group = 0;
+        bool active = true;
+
+        for (std::size_t i = 0; i < operations.size(); i++) {
+
+            const Operation& op = operations[i];
+
+            if (op.condition != group) {
+                group = op.condition;
+                active = group == 0 || backend.check(conditions[group-1].offset, conditions[group-1].size, conditions[group-1].value);
+            }
+            if (!active) continue;
+
+            if      (op.type == operation_u)       backend.u(op.qubits[0], op.params[0], op.params[1], op.params[2]);
+            else if (op.type == operation_cx)      backend.cx(op.qubits[0], op.qubits[1]);
+            else if (op.type == operation_unitary) backend.unitary(op.qubits, op.matrix);
+            else if (op.type == operation_measure) backend.measure(op.qubits[0], op.clbit);
+            else if (op.type == operation_reset)   backend.reset(op.qubits[0]);
+            else                                   backend.barrier(op.qubits);
+        }
+    }
+
+    Recorder::Recorder(Circuit& c):
+        Backend(c.qubit_space, c.clbit_space),
+        circuit(&c),
+        condition(0)
+    {
+    }
+
+    void Recorder::u(std::size_t q, double theta, double phi, double lambda) {
+        circuit->operations.emplace_back(operation_u, std::vector<std::size_t>{q}, condition);
+        circuit->operations.back().params = {theta, phi, lambda};
+    }
+
+    void Recorder::cx(std::size_t c, std::size_t t) {
+        circuit->operations.emplace_back(operation_cx, std::vector<std::size_t>{c, t}, condition);
+    }
+
+    void Recorder::measure(std::size_t q, std::size_t c) {
+        circuit->operations.emplace_back(operation_measure, std::vector<std::size_t>{q}, condition);
+        circuit->operations.back().clbit = c;
+    }
+
+    void Recorder::reset(std::size_t q) {
+        circuit->operations.emplace_back(operation_reset, std::vector<std::size_t>{q}, condition);
+    }
+
+    void Recorder::barrier(const std::vector<std::size_t>& q) {
+        circuit->operations.emplace_back(operation_barrier, q, condition);
+    }
+
+    bool Recorder::beginConditional(std::size_t offset, std::size_t size, const BigInt& num) {
+        circuit->conditions.emplace_back(offset, size, num);
+        condition = circuit->conditions.size();
+        return true;
+    }
+
+    void Recorder::endConditional() {
+        condition = 0;
+    }
+
+}
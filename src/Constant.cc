@@ -7,22 +7,55 @@
 namespace kazm {
 
     Constant::Constant(const std::string& v):
-        value(v)
+        value(v),
+        number(0.0),
+        valid(true)
     {
-    }
-
-    double Constant::evaluate() throw (Exception) {
         if (value == "pi") {
-            return atan2(1.0, 1.0) * 4.0;
+            number = atan2(1.0, 1.0) * 4.0;
         }
         else {
-            double d = strtod(value.c_str(), nullptr);
-            if (errno == ERANGE) throw Exception("<Internal error Constant::evaluate()> Unable to parse " + value + " as double precision floating point number");
-            return d;
+            errno = 0;
+            number = strtod(value.c_str(), nullptr);
+            if (errno == ERANGE) valid = false;
         }
     }
 
+    Constant::Constant(const std::string& v, double d):
+        value(v),
+        number(d),
+        valid(true)
+    {
+    }
+
+    double Constant::evaluate() throw (Exception) {
+        if (!valid) throw Exception("<Internal error Constant::evaluate()> Unable to parse " + value + " as double precision floating point number");
+        return number;
+    }
+
     std::string Constant::str() {
         return value;
     }
+
+    Expression* Constant::substitute(Arena&, const std::vector<Expression*>&) {
+        return this;
+    }
+
+    bool Constant::isConstant() {
+        return true;
+    }
+
+    void Constant::compile(Bytecode& code) {
+        code.constant(evaluate());
+    }
+
+    Expression* Constant::Fold(Arena& arena, Expression* e) {
+        if (!e->isConstant() || dynamic_cast<Constant*>(e)) return e;
+        try {
+            return arena.make<Constant>(e->str(), e->evaluate());
+        }
+        catch (const Exception& ex) {
+            return e;
+        }
+    }
 }
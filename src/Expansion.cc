@@ -0,0 +1,88 @@
+#include <Expansion.h>
+
+namespace kazm {
+
+    bool Step::first() const {
+        return lane == 0;
+    }
+
+    bool Step::last() const {
+        return lane + 1 == lanes;
+    }
+
+    void Step::execute(Backend& backend) const {
+        inst->execute(backend, lane);
+    }
+
+    Expansion::iterator::iterator(const Program& p, std::size_t i):
+        program(&p),
+        index(i)
+    {
+        load();
+    }
+
+    const Step& Expansion::iterator::operator*() const {
+        return step;
+    }
+
+    const Step* Expansion::iterator::operator->() const {
+        return &step;
+    }
+
+    Expansion::iterator& Expansion::iterator::operator++() {
+        if (++step.lane < step.lanes) return *this;
+        index++;
+        load();
+        return *this;
+    }
+
+    bool Expansion::iterator::operator==(const iterator& other) const {
+        return index == other.index && step.lane == other.step.lane;
+    }
+
+    bool Expansion::iterator::operator!=(const iterator& other) const {
+        return !(*this == other);
+    }
+
+    void Expansion::iterator::skip() {
+        index++;
+        load();
+    }
+
+    void Expansion::iterator::load() {
+
+        step.inst = nullptr;
+        step.guard = nullptr;
+        step.lane = 0;
+        step.lanes = 0;
+
+        if (index >= program->instructions.size()) return;
+
+        step.inst = program->instructions[index];
+        if (step.inst->type == instruction_if) {
+            step.guard = static_cast<const IfInst*>(step.inst);
+            step.inst = step.guard->inst;
+        }
+        step.lanes = step.inst->lanes();
+    }
+
+    Expansion::Expansion(const Program& p):
+        program(&p)
+    {
+    }
+
+    Expansion::iterator Expansion::begin() const {
+        return iterator(*program, 0);
+    }
+
+    Expansion::iterator Expansion::end() const {
+        return iterator(*program, program->instructions.size());
+    }
+
+    std::size_t Expansion::size() const {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < program->instructions.size(); i++) n += program->instructions[i]->lanes();
+        return n;
+    }
+
+}
@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include <Expression.h>
+#include <Constant.h>
 
 namespace kazm {
 
@@ -15,7 +16,7 @@ namespace kazm {
         {"sqrt", unaryop_sqrt}
     };
 
-    UnaryExpression::UnaryExpression(UnaryExpType o, const std::shared_ptr<Expression>& e):
+    UnaryExpression::UnaryExpression(UnaryExpType o, Expression* e):
         op(o),
         ex(e)
     {
@@ -43,6 +44,25 @@ namespace kazm {
         else return "(" + ex->str() + ")";
     }
 
+    Expression* UnaryExpression::substitute(Arena& arena, const std::vector<Expression*>& args) {
+        return Constant::Fold(arena, arena.make<UnaryExpression>(op, ex->substitute(arena, args)));
+    }
+
+    bool UnaryExpression::isConstant() {
+        return ex->isConstant();
+    }
+
+    void UnaryExpression::compile(Bytecode& code) {
+        ex->compile(code);
+        if (op == unaryop_negate) code.unary(opcode_negate);
+        else if (op == unaryop_sin) code.unary(opcode_sin);
+        else if (op == unaryop_cos) code.unary(opcode_cos);
+        else if (op == unaryop_tan) code.unary(opcode_tan);
+        else if (op == unaryop_exp) code.unary(opcode_exp);
+        else if (op == unaryop_ln) code.unary(opcode_ln);
+        else if (op == unaryop_sqrt) code.unary(opcode_sqrt);
+    }
+
     UnaryExpType UnaryExpression::GetType(const std::string& s) {
 
         return type[s];
@@ -64,7 +84,7 @@ namespace kazm {
         {"^", 400}
     };
 
-    BinaryExpression::BinaryExpression(BinaryExpType o, const std::shared_ptr<Expression>& l, const std::shared_ptr<Expression>& r):
+    BinaryExpression::BinaryExpression(BinaryExpType o, Expression* l, Expression* r):
         op(o),
         lhs(l),
         rhs(r)
@@ -87,6 +107,24 @@ namespace kazm {
         else return lhs->str() + " ^ " + rhs->str();
     }
 
+    Expression* BinaryExpression::substitute(Arena& arena, const std::vector<Expression*>& args) {
+        return Constant::Fold(arena, arena.make<BinaryExpression>(op, lhs->substitute(arena, args), rhs->substitute(arena, args)));
+    }
+
+    bool BinaryExpression::isConstant() {
+        return lhs->isConstant() && rhs->isConstant();
+    }
+
+    void BinaryExpression::compile(Bytecode& code) {
+        lhs->compile(code);
+        rhs->compile(code);
+        if (op == binaryop_add) code.binary(opcode_add);
+        else if (op == binaryop_subtract) code.binary(opcode_subtract);
+        else if (op == binaryop_multiply) code.binary(opcode_multiply);
+        else if (op == binaryop_divide) code.binary(opcode_divide);
+        else code.binary(opcode_raise);
+    }
+
     BinaryExpType BinaryExpression::GetType(const std::string& s) {
 
         return type[s];
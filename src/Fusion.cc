@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include <Fusion.h>
+
+namespace kazm {
+
+    static const std::size_t none = static_cast<std::size_t>(-1);
+
+    const std::size_t Fusion::max_width;
+
+    Fusion::Fusion(std::size_t w, KernelType k):
+        _input(nullptr),
+        _output(nullptr),
+        width(w),
+        kernel(k)
+    {
+    }
+
+    void Fusion::close(std::size_t b) {
+        Block& block = _blocks[b];
+        if (block.ops.empty()) return;
+        emit(block);
+        for (std::size_t i = 0; i < block.qubits.size(); i++) _owner[block.qubits[i]] = none;
+        block.qubits.clear();
+        block.ops.clear();
+    }
+
+    void Fusion::emit(const Block& block) {
+
+        if (block.ops.size() == 1) {
+            _output->operations.push_back(_input->operations[block.ops[0]]);
+            return;
+        }
+
+        std::size_t k = block.qubits.size();
+        std::size_t dim = std::size_t(1) << k;
+
+        std::vector<std::complex<double> > m(dim*dim, 0.0);
+        for (std::size_t i = 0; i < dim; i++) m[i*dim+i] = 1.0;
+
+        auto local = [&](std::size_t q) {
+            return std::size_t(std::find(block.qubits.begin(), block.qubits.end(), q) - block.qubits.begin());
+        };
+
+        for (std::size_t i = 0; i < block.ops.size(); i++) {
+
+            const Operation& op = _input->operations[block.ops[i]];
+
+            if (op.type == operation_u) {
+                double u[8];
+                Kernels::UMatrix(op.params[0], op.params[1], op.params[2], u);
+                Kernels::ApplyU(kernel, m.data(), k + local(op.qubits[0]), u, 0, dim*dim/2);
+            }
+            else Kernels::ApplyCX(kernel, m.data(), k + local(op.qubits[0]), k + local(op.qubits[1]), 0, dim*dim/4);
+        }
+
+        _output->operations.emplace_back(operation_unitary, block.qubits, 0);
+        _output->operations.back().matrix = std::move(m);
+    }
+
+    void Fusion::run(const Circuit& input, Circuit& output) {
+
+        _input = &input;
+        _output = &output;
+        _blocks.clear();
+        _owner.assign(input.qubit_space, none);
+
+        output.conditions = input.conditions;
+
+        for (std::size_t i = 0; i < input.operations.size(); i++) {
+
+            const Operation& op = input.operations[i];
+
+            if (op.condition != 0 || !op.isUnitary() || op.type == operation_unitary) {
+                if (op.condition != 0) {
+                    for (std::size_t q = 0; q < _owner.size(); q++) {
+                        if (_owner[q] != none) close(_owner[q]);
+                    }
+                }
+                else {
+                    for (std::size_t j = 0; j < op.qubits.size(); j++) {
+                        if (_owner[op.qubits[j]] != none) close(_owner[op.qubits[j]]);
+                    }
+                }
+                output.operations.push_back(op);
+                continue;
+            }
+
+            std::vector<std::size_t> touched;
+            std::vector<std::size_t> qubits;
+            for (std::size_t j = 0; j < op.qubits.size(); j++) {
+                std::size_t b = _owner[op.qubits[j]];
+                if (b == none) qubits.push_back(op.qubits[j]);
+                else if (std::find(touched.begin(), touched.end(), b) == touched.end()) touched.push_back(b);
+            }
+            for (std::size_t j = 0; j < touched.size(); j++) {
+                const Block& block = _blocks[touched[j]];
+                qubits.insert(qubits.end(), block.qubits.begin(), block.qubits.end());
+            }
+
+            if (qubits.size() > width) {
+                for (std::size_t j = 0; j < touched.size(); j++) close(touched[j]);
+                if (op.qubits.size() > width) {
+                    output.operations.push_back(op);
+                    continue;
+                }
+                touched.clear();
+            }
+
+            std::size_t target = touched.empty() ? _blocks.size() : touched[0];
+            if (touched.empty()) _blocks.push_back(Block());
+
+            Block& block = _blocks[target];
+            for (std::size_t j = 1; j < touched.size(); j++) {
+                Block& other = _blocks[touched[j]];
+                block.qubits.insert(block.qubits.end(), other.qubits.begin(), other.qubits.end());
+                block.ops.insert(block.ops.end(), other.ops.begin(), other.ops.end());
+                other.qubits.clear();
+                other.ops.clear();
+            }
+            for (std::size_t j = 0; j < op.qubits.size(); j++) {
+                if (_owner[op.qubits[j]] == none) block.qubits.push_back(op.qubits[j]);
+            }
+            for (std::size_t j = 0; j < block.qubits.size(); j++) _owner[block.qubits[j]] = target;
+            block.ops.push_back(i);
+        }
+
+        for (std::size_t b = 0; b < _blocks.size(); b++) close(b);
+    }
+
+}
@@ -3,22 +3,41 @@
 #include <Gate.h>
 #include <Instruction.h>
 #include <Parameter.h>
-#include <Argument.h>
+#include <Kernels.h>
 
 namespace kazm {
 
-    Gate::Gate(const std::string& n, const std::vector<std::string>& pn, const std::vector<std::string>& bn):
+    static const std::size_t max_unitary_qubits = 10;
+    static const std::size_t max_unitaries = 1024;
+
+    GateOp::GateOp(OperationType t, const std::vector<std::size_t>& q):
+        type(t),
+        qubits(q)
+    {
+    }
+
+    Gate::Gate(Arena& a, const std::string& n, const std::vector<std::string>& pn, const std::vector<std::string>& bn):
         name(n),
         nparams(pn.size()),
-        nqubits(bn.size())
+        nqubits(bn.size()),
+        compiled(false),
+        opaque(nullptr),
+        arena(&a)
     {
         for (std::size_t i = 0; i < pn.size(); i++) param_names.push_back(pn[i]);
         for (std::size_t i = 0; i < bn.size(); i++) qubit_names.push_back(bn[i]);
-        for (std::size_t i = 0; i < param_names.size(); i++) param_map[param_names[i]] = i;
-        for (std::size_t i = 0; i < qubit_names.size(); i++) qubit_map[qubit_names[i]] = i;
-        for (std::size_t i = 0; i < param_names.size(); i++) pstack.push_back(std::make_shared<Parameter>(param_names[i]));
-        for (std::size_t i = 0; i < qubit_names.size(); i++) bstack.push_back(std::make_shared<Argument>(qubit_names[i]));
+        for (std::size_t i = 0; i < param_names.size(); i++) pstack.push_back(arena->make<Parameter>(param_names[i], i));
+        for (std::size_t i = 0; i < param_names.size(); i++) params.push_back(pstack[i]);
+    }
+
+    std::size_t Gate::qubit(std::size_t id) const {
+        if (id >= qubit_slots.size() || qubit_slots[id] == 0) return static_cast<std::size_t>(-1);
+        return qubit_slots[id] - 1;
+    }
 
+    void Gate::mapQubit(std::size_t id, std::size_t index) {
+        if (id >= qubit_slots.size()) qubit_slots.resize(id + 1, 0);
+        qubit_slots[id] = index + 1;
     }
 
     std::string Gate::str() {
@@ -49,32 +68,153 @@ namespace kazm {
 
         return ss.str();
     }
+
+    std::string Gate::str(Operand op) const {
+        return qubit_names[op.reg()];
+    }
         
-    void Gate::execute(const Program& prog, const std::vector<std::size_t>& p, const std::vector<std::size_t>& b) throw (Exception) {
-        if (p.size() != nparams) throw Exception("<Internal error Gate::execute()> Incorrect number of parameters passed to gate " + name);    
-        if (b.size() != nqubits) throw Exception("<Internal error Gate::execute()> Incorrect number of qubits passed to gate " + name);
+    void Gate::compile() throw (Exception) {
 
-        for (std::size_t i = 0; i < p.size(); i++) {
-            auto par = dynamic_cast<Parameter*>(pstack[i].get());
-            par->value = prog.pstack[p[i]];
+        if (compiled) return;
+
+        body.clear();
+
+        for (std::size_t i = 0; i < instructions.size(); i++) {
+            Instruction* inst = instructions[i];
+            if (inst->type == instruction_barrier) {
+                auto barrier = dynamic_cast<BarrierInst*>(inst);
+                std::vector<std::size_t> qubits;
+                for (std::size_t k = 0; k < barrier->count; k++) qubits.push_back(operands[barrier->first+k].reg());
+                body.push_back(GateOp(operation_barrier, qubits));
+            }
+            else if (inst->type == instruction_call) {
+                auto call = dynamic_cast<CallInst*>(inst);
+                call->gate->compile();
+                if (!opaque) opaque = call->gate->opaque;
+                std::vector<Expression*> args;
+                for (std::size_t j = 0; j < call->gate->nparams; j++) args.push_back(pstack[call->params+j]);
+                for (std::size_t j = 0; j < call->gate->body.size(); j++) {
+                    const GateOp& callee_op = call->gate->body[j];
+                    std::vector<std::size_t> qubits;
+                    for (std::size_t k = 0; k < callee_op.qubits.size(); k++) qubits.push_back(operands[call->bits+callee_op.qubits[k]].reg());
+                    GateOp op(callee_op.type, qubits);
+                    for (std::size_t k = 0; k < callee_op.params.size(); k++) op.params.push_back(callee_op.params[k]->substitute(*arena, args));
+                    body.push_back(std::move(op));
+                }
+            }
+            else throw Exception("<Internal error Gate::compile()> Unexpected instruction in body of gate " + name);
         }
-        for (std::size_t i = 0; i < b.size(); i++) {
-            auto arg = dynamic_cast<Argument*>(bstack[i].get());
-            auto caller_arg = dynamic_cast<Argument*>(prog.bstack[b[i]].get());
-            if (caller_arg == nullptr) arg->set(prog.bstack[b[i]]);
-            else arg->set(caller_arg->arg());
+
+        for (std::size_t i = 0; i < body.size(); i++) {
+            body[i].code.assign(body[i].params.size(), Bytecode());
+            for (std::size_t j = 0; j < body[i].params.size(); j++) body[i].params[j]->compile(body[i].code[j]);
         }
 
-        for (std::size_t i = 0; i < instructions.size(); i++) instructions[i]->execute();
+        compiled = true;
+    }
+
+    void Gate::execute(const Program& prog, std::size_t p, std::size_t b, std::size_t lane, Backend& backend) const throw (Exception) {
+        if (p + nparams > prog.pstack.size()) throw Exception("<Internal error Gate::execute()> Incorrect number of parameters passed to gate " + name);
+        if (b + nqubits > prog.operands.size()) throw Exception("<Internal error Gate::execute()> Incorrect number of qubits passed to gate " + name);
+        if (!compiled) throw Exception("<Internal error Gate::execute()> Gate " + name + " is not compiled");
+
+        std::vector<double>& args = backend.frame.args;
+        args.resize(nparams);
+        for (std::size_t i = 0; i < nparams; i++) args[i] = backend.parameters ? (*backend.parameters)[p+i] : prog.pstack[p+i]->evaluate();
 
-        for (std::size_t i = 0; i < p.size(); i++) {
-            auto par = dynamic_cast<Parameter*>(pstack[i].get());
-            par->value.reset();
+        std::vector<std::size_t>& offsets = backend.frame.offsets;
+        offsets.resize(nqubits);
+        for (std::size_t i = 0; i < nqubits; i++) {
+            Operand q = prog.operands[b+i];
+            offsets[i] = prog.offset(q) + (q.broadcast() ? lane : 0);
         }
-        for (std::size_t i = 0; i < b.size(); i++) {
-            auto arg = dynamic_cast<Argument*>(bstack[i].get());
-            arg->reset();
+
+        std::vector<std::size_t>& qubits = backend.frame.qubits;
+        for (std::size_t i = 0; i < body.size(); i++) {
+            const GateOp& op = body[i];
+            qubits.clear();
+            for (std::size_t k = 0; k < op.qubits.size(); k++) qubits.push_back(offsets[op.qubits[k]]);
+            if (op.type == operation_u) backend.u(qubits[0], op.code[0].evaluate(args.data()), op.code[1].evaluate(args.data()), op.code[2].evaluate(args.data()));
+            else if (op.type == operation_cx) backend.cx(qubits[0], qubits[1]);
+            else if (op.type == operation_barrier) backend.barrier(qubits);
         }
     }
 
+    void Gate::unitary(const std::vector<double>& args, KernelType kernel, std::vector<std::complex<double> >& matrix) const throw (Exception) {
+
+        if (args.size() != nparams) {
+            std::stringstream ss;
+            ss << "Gate " << name << " expects " << nparams << " parameters, found " << args.size();
+            throw Exception(ss.str());
+        }
+        if (nqubits > max_unitary_qubits) throw Exception("Gate " + name + " acts on too many qubits for a dense unitary");
+
+        if (!compiled) throw Exception("<Internal error Gate::unitary()> Gate " + name + " is not compiled");
+        if (opaque) throw Exception("Gate " + opaque->name + " is opaque and has no unitary");
+
+        {
+            std::lock_guard<std::mutex> lock(unitary_mutex);
+            auto it = unitaries.find(args);
+            if (it != unitaries.end()) {
+                unitary_ages.splice(unitary_ages.begin(), unitary_ages, it->second.age);
+                matrix = it->second.matrix;
+                return;
+            }
+        }
+
+        std::size_t dim = std::size_t(1) << nqubits;
+
+        matrix.assign(dim*dim, 0.0);
+        for (std::size_t i = 0; i < dim; i++) matrix[i*dim+i] = 1.0;
+
+        for (std::size_t i = 0; i < body.size(); i++) {
+            const GateOp& op = body[i];
+            if (op.type == operation_u) {
+                double u[8];
+                Kernels::UMatrix(op.code[0].evaluate(args.data()), op.code[1].evaluate(args.data()), op.code[2].evaluate(args.data()), u);
+                Kernels::ApplyU(kernel, matrix.data(), nqubits + op.qubits[0], u, 0, dim*dim/2);
+            }
+            else if (op.type == operation_cx) {
+                Kernels::ApplyCX(kernel, matrix.data(), nqubits + op.qubits[0], nqubits + op.qubits[1], 0, dim*dim/4);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(unitary_mutex);
+        if (unitaries.count(args)) return;
+        unitary_ages.push_front(args);
+        unitaries[args] = CachedUnitary{matrix, unitary_ages.begin()};
+        if (unitaries.size() > max_unitaries) {
+            unitaries.erase(unitary_ages.back());
+            unitary_ages.pop_back();
+        }
+    }
+
+    UGate::UGate(Arena& a, const std::string& n, const std::vector<std::string>& pn, const std::vector<std::string>& bn):
+        Gate(a, n, pn, bn)
+    {
+    }
+
+    void UGate::compile() throw (Exception) {
+        if (compiled) return;
+        GateOp op(operation_u, {0});
+        for (std::size_t i = 0; i < nparams; i++) {
+            op.params.push_back(pstack[i]);
+            op.code.push_back(Bytecode());
+            pstack[i]->compile(op.code.back());
+        }
+        body.push_back(std::move(op));
+        compiled = true;
+    }
+
+    CXGate::CXGate(Arena& a, const std::string& n, const std::vector<std::string>& pn, const std::vector<std::string>& bn):
+        Gate(a, n, pn, bn)
+    {
+    }
+
+    void CXGate::compile() throw (Exception) {
+        if (compiled) return;
+        body.push_back(GateOp(operation_cx, {0, 1}));
+        compiled = true;
+    }
+
 }
@@ -0,0 +1,345 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <IR.h>
+#include <Parser.h>
+#include <Binary.h>
+#include <Parameter.h>
+
+namespace kazm {
+
+    static const uint64_t ir_magic = 0x313052494d5a414bull;
+    static const uint64_t ir_version = 3;
+    static const uint64_t ir_none = static_cast<uint64_t>(-1);
+
+    template<class T>
+    static void Place(IRSection& s, const std::vector<T>& v, uint64_t& offset) {
+        s.offset = offset;
+        s.count = v.size();
+        offset += v.size() * sizeof(T);
+    }
+
+    static void Place(IRSection& s, const std::string& v, uint64_t& offset) {
+        s.offset = offset;
+        s.count = v.size();
+        offset += v.size();
+    }
+
+    template<class T>
+    static void Append(std::string& out, const std::vector<T>& v) {
+        out.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    IRWriter::IRWriter():
+        defined(0)
+    {
+    }
+
+    uint64_t IRWriter::string(const std::string& s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        strings.push_back(IRString{text.size(), s.size()});
+        text.append(s);
+        ids[s] = strings.size() - 1;
+        return strings.size() - 1;
+    }
+
+    void IRWriter::instruction(Instruction* inst) throw (Exception) {
+
+        if (inst->type == instruction_barrier) {
+            auto barrier = dynamic_cast<BarrierInst*>(inst);
+            instructions.push_back(IRInstruction{instruction_barrier, barrier->first, barrier->count, 0});
+        }
+        else if (inst->type == instruction_measure) {
+            auto measure = dynamic_cast<MeasureInst*>(inst);
+            instructions.push_back(IRInstruction{instruction_measure, measure->q.word, measure->c.word, 0});
+        }
+        else if (inst->type == instruction_reset) {
+            auto reset = dynamic_cast<ResetInst*>(inst);
+            instructions.push_back(IRInstruction{instruction_reset, reset->q.word, 0, 0});
+        }
+        else if (inst->type == instruction_call) {
+            auto call = dynamic_cast<CallInst*>(inst);
+            instructions.push_back(IRInstruction{instruction_call, indices.at(call->gate), call->params, call->bits});
+        }
+        else if (inst->type == instruction_if) {
+            auto cond = dynamic_cast<IfInst*>(inst);
+            instructions.push_back(IRInstruction{instruction_if, cond->creg.word, string(cond->num.str), 0});
+            instruction(cond->inst);
+        }
+        else throw Exception("<Internal error IRWriter::instruction()> Unknown instruction type");
+    }
+
+    void IRWriter::gate(const Gate* g) throw (Exception) {
+
+        if (indices.count(g)) return;
+
+        for (Instruction* inst : g->instructions) {
+            if (inst->type == instruction_call) gate(dynamic_cast<CallInst*>(inst)->gate);
+        }
+
+        indices[g] = gates.size();
+        gates.push_back(string(g->name));
+        if (g->name.compare(0, 2, "__") == 0) return;
+        library.gate(*g);
+        defined++;
+    }
+
+    void IRWriter::write(Parser& parser, const std::string& filename) throw (Exception) {
+
+        IRHeader h;
+        std::memset(&h, 0, sizeof(h));
+        h.magic = ir_magic;
+        h.version = ir_version;
+        h.qasm_major = parser.qasm_version ? parser.qasm_version->first : ir_none;
+        h.qasm_minor = parser.qasm_version ? parser.qasm_version->second : ir_none;
+
+        h.params = names.size();
+        h.nparams = parser.program.param_names.size();
+        for (const std::string& s : parser.program.param_names) names.push_back(string(s));
+
+        for (Register* reg : parser.program.registers) {
+            registers.push_back(IRRegister{static_cast<uint64_t>(reg->type()), string(reg->name()), reg->size(), reg->offset()});
+        }
+
+        for (Gate* g : parser.gates) {
+            if (g) gate(g);
+        }
+
+        BinaryWriter lib;
+        lib.word(defined);
+        lib.data.append(library.data);
+
+        BinaryWriter pstack;
+        pstack.word(parser.program.pstack.size());
+        for (Expression* e : parser.program.pstack) pstack.expression(e);
+
+        for (Operand op : parser.program.operands) operands.push_back(op.word);
+        for (Instruction* inst : parser.program.instructions) instruction(inst);
+
+        text.append((8 - text.size() % 8) % 8, '\0');
+
+        uint64_t offset = sizeof(IRHeader);
+        Place(h.strings, strings, offset);
+        Place(h.text, text, offset);
+        Place(h.names, names, offset);
+        Place(h.registers, registers, offset);
+        Place(h.gates, gates, offset);
+        Place(h.library, lib.data, offset);
+        Place(h.pstack, pstack.data, offset);
+        Place(h.operands, operands, offset);
+        Place(h.instructions, instructions, offset);
+
+        std::string out;
+        out.reserve(offset);
+        out.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        Append(out, strings);
+        out.append(text);
+        Append(out, names);
+        Append(out, registers);
+        Append(out, gates);
+        out.append(lib.data);
+        out.append(pstack.data);
+        Append(out, operands);
+        Append(out, instructions);
+
+        FILE* f = fopen(filename.c_str(), "wb");
+        if (!f) throw Exception("Unable to open " + filename);
+        bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+        ok = fclose(f) == 0 && ok;
+        if (!ok) throw Exception("Unable to write " + filename);
+    }
+
+    IRReader::IRReader(const std::string& f) throw (Exception):
+        filename(f),
+        data(nullptr),
+        size(0),
+        mapped(false),
+        header(nullptr)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw Exception("Unable to open " + filename);
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char*>(p);
+                size = st.st_size;
+                mapped = true;
+            }
+        }
+
+        if (!mapped) {
+            char buf[65536];
+            ssize_t n;
+            while ((n = ::read(fd, buf, sizeof(buf))) > 0) contents.append(buf, n);
+            if (n < 0) {
+                close(fd);
+                throw Exception("Unable to read " + filename);
+            }
+            data = contents.data();
+            size = contents.size();
+        }
+
+        close(fd);
+
+        if (size < sizeof(IRHeader)) throw Exception(filename + " is not a kazm IR file");
+        header = reinterpret_cast<const IRHeader*>(data);
+        if (header->magic != ir_magic) throw Exception(filename + " is not a kazm IR file");
+        if (header->version != ir_version) throw Exception("Unsupported IR version in " + filename);
+
+        std::pair<const IRSection*, std::size_t> sections[] = {
+            {&header->strings, sizeof(IRString)},
+            {&header->text, 1},
+            {&header->names, sizeof(uint64_t)},
+            {&header->registers, sizeof(IRRegister)},
+            {&header->gates, sizeof(uint64_t)},
+            {&header->library, 1},
+            {&header->pstack, 1},
+            {&header->operands, sizeof(uint64_t)},
+            {&header->instructions, sizeof(IRInstruction)}
+        };
+        for (auto& s : sections) {
+            const IRSection& sec = *s.first;
+            if (sec.offset % sizeof(uint64_t) != 0 || sec.offset > size || sec.count > (size - sec.offset) / s.second) throw Exception("Truncated IR file " + filename);
+        }
+    }
+
+    IRReader::~IRReader() {
+        if (mapped) munmap(const_cast<char*>(data), size);
+    }
+
+    std::string IRReader::string(uint64_t id) throw (Exception) {
+        const IRString& s = *section<IRString>(header->strings, id, 1);
+        return std::string(section<char>(header->text, s.offset, s.size), s.size);
+    }
+
+    BinaryReader IRReader::bytes(const IRSection& s) {
+        return BinaryReader(data + s.offset, s.count);
+    }
+
+    Operand IRReader::operand(const Program& prog, uint64_t word, DataType type) throw (Exception) {
+        Operand op;
+        op.word = word;
+        if (op.reg() >= prog.registers.size() || prog.registers[op.reg()]->type() != type) throw Exception("Invalid operand in " + filename);
+        if (!op.broadcast() && op.index() >= prog.reg_sizes[op.reg()]) throw Exception("Invalid operand in " + filename);
+        return op;
+    }
+
+    Instruction* IRReader::instruction(Arena& arena, Program& prog, const IRInstruction& r) throw (Exception) {
+
+        if (r.type == instruction_barrier) {
+            if (r.a > prog.operands.size() || r.b > prog.operands.size() - r.a || !prog.checkOperands(r.a, r.b).empty()) throw Exception("Invalid barrier in " + filename);
+            return arena.make<BarrierInst>(prog, r.a, r.b);
+        }
+        else if (r.type == instruction_measure) {
+            Operand q = operand(prog, r.a, data_quantum);
+            Operand c = operand(prog, r.b, data_classical);
+            if (!prog.checkMeasure(q, c).empty()) throw Exception("Invalid measure in " + filename);
+            return arena.make<MeasureInst>(prog, q, c);
+        }
+        else if (r.type == instruction_reset) {
+            return arena.make<ResetInst>(prog, operand(prog, r.a, data_quantum));
+        }
+        else if (r.type == instruction_call) {
+            if (r.a >= gates.size()) throw Exception("Invalid gate in " + filename);
+            Gate* target = gates[r.a];
+            if (r.b > prog.pstack.size() || target->nparams > prog.pstack.size() - r.b) throw Exception("Invalid parameters for gate " + target->name + " in " + filename);
+            if (r.c > prog.operands.size() || target->nqubits > prog.operands.size() - r.c || !prog.checkOperands(r.c, target->nqubits).empty()) throw Exception("Invalid qubits for gate " + target->name + " in " + filename);
+            return arena.make<CallInst>(prog, target, r.b, r.c);
+        }
+
+        throw Exception("Invalid instruction in " + filename);
+    }
+
+    void IRReader::read(Parser& parser) throw (Exception) {
+
+        if (header->qasm_major != ir_none) parser.qasm_version = std::make_shared<std::pair<std::size_t, std::size_t> >(header->qasm_major, header->qasm_minor);
+
+        auto claim = [&](const std::string& name, bool reg) -> std::size_t {
+            std::size_t id = parser.symbols.intern(name);
+            parser.define(id);
+            if (parser.isGate(id) || (reg && (parser.isCReg(id) || parser.isQReg(id)))) throw Exception(name + " is defined more than once in " + filename);
+            return id;
+        };
+
+        const uint64_t* pnames = section<uint64_t>(header->names, header->params, header->nparams);
+        for (uint64_t i = 0; i < header->nparams; i++) {
+            std::string name = string(pnames[i]);
+            parser.program.mapParam(parser.symbols.intern(name), i);
+            parser.program.param_names.push_back(name);
+            parser.program.params.push_back(parser.arena.make<Parameter>(name, i));
+        }
+
+        const IRRegister* regs = section<IRRegister>(header->registers, 0, header->registers.count);
+        for (uint64_t i = 0; i < header->registers.count; i++) {
+            const IRRegister& r = regs[i];
+            std::size_t& space = r.type == data_classical ? parser.clbit_space : parser.qubit_space;
+            if (r.type > data_quantum || r.size == 0 || r.size > Operand::max_index || r.offset != space || space + r.size < space) throw Exception("Invalid register in " + filename);
+            std::string name = string(r.name);
+            std::size_t id = claim(name, true);
+            auto reg = parser.arena.make<Register>(static_cast<DataType>(r.type), name, r.size, r.offset, parser.program.registers.size());
+            (r.type == data_classical ? parser.cregs : parser.qregs)[id] = reg;
+            parser.program.addRegister(reg);
+            space += r.size;
+        }
+
+        auto resolve = [&](const std::string& name) -> Gate* {
+            std::size_t id = parser.symbols.find(name);
+            return parser.isGate(id) ? parser.gates[id] : nullptr;
+        };
+
+        BinaryReader library = bytes(header->library);
+        uint64_t defined = library.count();
+        for (uint64_t i = 0; i < defined; i++) {
+            Gate* g = library.gate(parser.arena, resolve);
+            parser.gates[claim(g->name, false)] = g;
+        }
+        if (library.pos != library.size) throw Exception("Invalid gate library in " + filename);
+
+        const uint64_t* table = section<uint64_t>(header->gates, 0, header->gates.count);
+        gates.reserve(header->gates.count);
+        for (uint64_t i = 0; i < header->gates.count; i++) {
+            std::string name = string(table[i]);
+            Gate* g = resolve(name);
+            if (!g) throw Exception("Unknown gate " + name + " in " + filename);
+            gates.push_back(g);
+        }
+
+        Program& prog = parser.program;
+
+        BinaryReader pstack = bytes(header->pstack);
+        uint64_t npstack = pstack.count();
+        prog.pstack.reserve(npstack);
+        for (uint64_t i = 0; i < npstack; i++) prog.pstack.push_back(pstack.expression(parser.arena, prog));
+        if (pstack.pos != pstack.size) throw Exception("Invalid parameter stack in " + filename);
+
+        const uint64_t* words = section<uint64_t>(header->operands, 0, header->operands.count);
+        prog.operands.reserve(header->operands.count);
+        for (uint64_t i = 0; i < header->operands.count; i++) prog.operands.push_back(operand(prog, words[i], data_quantum));
+
+        const IRInstruction* insts = section<IRInstruction>(header->instructions, 0, header->instructions.count);
+        uint64_t ninstructions = header->instructions.count;
+        prog.instructions.reserve(ninstructions);
+        for (uint64_t i = 0; i < ninstructions; i++) {
+            if (insts[i].type == instruction_if) {
+                if (i + 1 == ninstructions || insts[i+1].type == instruction_if || insts[i+1].type == instruction_barrier) throw Exception("Invalid if statement in " + filename);
+                Operand creg;
+                creg.word = insts[i].a;
+                if (!creg.broadcast() || creg.reg() >= prog.registers.size() || prog.registers[creg.reg()]->type() != data_classical) throw Exception("Invalid if statement in " + filename);
+                std::string num = string(insts[i].b);
+                if (num.empty() || num.find_first_not_of("0123456789") != std::string::npos) throw Exception("Invalid if statement in " + filename);
+                Instruction* inst = instruction(parser.arena, prog, insts[++i]);
+                prog.instructions.push_back(parser.arena.make<IfInst>(prog, creg, num, inst));
+            }
+            else prog.instructions.push_back(instruction(parser.arena, prog, insts[i]));
+        }
+    }
+
+}
@@ -0,0 +1,195 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <set>
+#include <functional>
+
+#include <IncludeCache.h>
+#include <Parser.h>
+#include <Instruction.h>
+#include <Binary.h>
+
+namespace kazm {
+
+    static const uint64_t snapshot_magic = 0x31434e494d5a414bull;
+    static const uint64_t snapshot_version = 3;
+
+    static bool ReadFile(const std::string& filename, std::string& contents) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) contents.append(buf, n);
+        close(fd);
+        return n == 0;
+    }
+
+    IncludeCache::IncludeCache():
+        hits(0),
+        misses(0)
+    {
+    }
+
+    IncludeCache& IncludeCache::Shared() {
+        static IncludeCache cache;
+        return cache;
+    }
+
+    uint64_t IncludeCache::Hash(const char* data, std::size_t size, uint64_t h) {
+        for (std::size_t i = 0; i < size; i++) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    void IncludeCache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _libraries.clear();
+    }
+
+    std::shared_ptr<Library> IncludeCache::find(const std::string& filename, const std::shared_ptr<std::pair<std::size_t, std::size_t> >& version) {
+
+        std::string contents;
+        if (!ReadFile(filename, contents)) return nullptr;
+        uint64_t hash = Hash(contents.data(), contents.size());
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto key = std::make_pair(filename, hash);
+        auto it = _libraries.find(key);
+        if (it != _libraries.end()) {
+            hits++;
+            return it->second;
+        }
+
+        misses++;
+        std::shared_ptr<Library> library;
+        if (!directory.empty()) library = load(filename, hash);
+        if (!library) {
+            library = build(filename, version);
+            if (library && !directory.empty()) save(*library, filename, hash);
+        }
+        _libraries[key] = library;
+        return library;
+    }
+
+    std::shared_ptr<Library> IncludeCache::build(const std::string& filename, const std::shared_ptr<std::pair<std::size_t, std::size_t> >& version) {
+
+        auto library = std::make_shared<Library>();
+        library->parser = std::make_shared<Parser>();
+
+        Parser& parser = *library->parser;
+        std::set<Gate*> builtins(parser.gates.begin(), parser.gates.end());
+        parser.includes = nullptr;
+        parser.qasm_version = version;
+
+        try {
+            parser.parse(filename);
+        }
+        catch (const Exception& e) {
+            return nullptr;
+        }
+
+        if (!parser.included.empty() || !parser.program.instructions.empty() || !parser.program.registers.empty() || !parser.program.params.empty()) return nullptr;
+
+        for (std::size_t i = 0; i < parser.gates.size(); i++) {
+            if (parser.gates[i] && !builtins.count(parser.gates[i])) library->gates.push_back(parser.gates[i]);
+        }
+        return library;
+    }
+
+    std::string IncludeCache::path(const std::string& filename, uint64_t hash) const {
+        std::stringstream ss;
+        ss << directory << "/" << std::hex << std::setfill('0') << std::setw(16) << Hash(filename.data(), filename.size()) << "-" << std::setw(16) << hash << ".kzi";
+        return ss.str();
+    }
+
+    std::shared_ptr<Library> IncludeCache::load(const std::string& filename, uint64_t hash) {
+
+        std::string contents;
+        if (!ReadFile(path(filename, hash), contents)) return nullptr;
+        if (contents.size() < sizeof(uint64_t)) return nullptr;
+        std::size_t size = contents.size() - sizeof(uint64_t);
+        if (BinaryReader(contents.data() + size, sizeof(uint64_t)).word() != Hash(contents.data(), size)) return nullptr;
+
+        auto library = std::make_shared<Library>();
+        library->parser = std::make_shared<Parser>();
+        Parser& parser = *library->parser;
+        parser.includes = nullptr;
+
+        std::map<std::string, Gate*> known;
+        for (Gate* g : parser.gates) {
+            if (g) known[g->name] = g;
+        }
+        auto resolve = [&](const std::string& name) -> Gate* {
+            auto it = known.find(name);
+            return it == known.end() ? nullptr : it->second;
+        };
+
+        try {
+            BinaryReader reader(contents.data(), size);
+            if (reader.word() != snapshot_magic || reader.word() != snapshot_version) return nullptr;
+            if (reader.text() != filename || reader.word() != hash) return nullptr;
+            uint64_t count = reader.count();
+            for (uint64_t i = 0; i < count; i++) {
+                Gate* g = reader.gate(parser.arena, resolve);
+                if (known.count(g->name)) return nullptr;
+                known[g->name] = g;
+                std::size_t id = parser.symbols.intern(g->name);
+                parser.define(id);
+                parser.gates[id] = g;
+                library->gates.push_back(g);
+            }
+            if (reader.pos != reader.size) return nullptr;
+        }
+        catch (const std::exception& e) {
+            return nullptr;
+        }
+
+        return library;
+    }
+
+    void IncludeCache::save(const Library& library, const std::string& filename, uint64_t hash) {
+
+        BinaryWriter writer;
+        writer.word(snapshot_magic);
+        writer.word(snapshot_version);
+        writer.text(filename);
+        writer.word(hash);
+        writer.word(library.gates.size());
+
+        std::set<const Gate*> members(library.gates.begin(), library.gates.end());
+        std::set<const Gate*> written;
+        std::function<void(const Gate*)> emit = [&](const Gate* g) {
+            if (!members.count(g) || written.count(g)) return;
+            written.insert(g);
+            for (Instruction* inst : g->instructions) {
+                if (inst->type == instruction_call) emit(dynamic_cast<CallInst*>(inst)->gate);
+            }
+            writer.gate(*g);
+        };
+
+        try {
+            for (const Gate* g : library.gates) emit(g);
+        }
+        catch (const Exception& e) {
+            return;
+        }
+
+        writer.word(Hash(writer.data.data(), writer.data.size()));
+
+        std::string target = path(filename, hash);
+        std::stringstream tmp;
+        tmp << target << "." << getpid();
+        FILE* f = fopen(tmp.str().c_str(), "wb");
+        if (!f) return;
+        bool ok = fwrite(writer.data.data(), 1, writer.data.size(), f) == writer.data.size();
+        ok = fclose(f) == 0 && ok;
+        if (!ok || rename(tmp.str().c_str(), target.c_str()) != 0) remove(tmp.str().c_str());
+    }
+
+}
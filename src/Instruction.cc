@@ -2,7 +2,6 @@
 
 #include <Instruction.h>
 #include <Expression.h>
-#include <Bit.h>
 
 namespace kazm {
 
@@ -12,34 +11,44 @@ namespace kazm {
     {
     }
 
-    BarrierInst::BarrierInst(const Program& c, const std::vector<std::size_t>& q):
-        Instruction(instruction_barrier, c)
+    std::size_t Instruction::lanes() const {
+        return 1;
+    }
+
+    BarrierInst::BarrierInst(const Program& c, std::size_t f, std::size_t n):
+        Instruction(instruction_barrier, c),
+        first(f),
+        count(n)
     {
-        for (const std::size_t& i : q) bits.push_back(i);
     }
 
     std::string BarrierInst::str() {
         std::stringstream ss;
         ss << "barrier on ";
-        for (std::size_t i = 0; i < bits.size(); i++) {
-            auto b = caller->bstack[bits[i]];
-            ss << b->name();
-            try {
-                if (b->isBit()) ss << "[" << dynamic_cast<Bit*>(b.get())->index() << "]";
-            }
-            catch (const kazm::Exception& e) {
-            }
-            if (i != bits.size()-1) ss << ",";
+        for (std::size_t i = 0; i < count; i++) {
+            ss << caller->str(caller->operands[first+i]);
+            if (i != count-1) ss << ",";
             ss << " ";
         }
         ss << std::endl;
         return ss.str();
     }
 
-    void BarrierInst::execute() {
+    void BarrierInst::execute(Backend& backend, std::size_t) const {
+
+        std::vector<std::size_t>& qubits = backend.frame.qubits;
+        qubits.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            Operand qb = caller->operands[first+i];
+            std::size_t offset = caller->offset(qb);
+            std::size_t size = caller->size(qb);
+            for (std::size_t j = 0; j < size; j++) qubits.push_back(offset+j);
+        }
+
+        backend.barrier(qubits);
     }
 
-    MeasureInst::MeasureInst(const Program& c, std::size_t q_, std::size_t c_):
+    MeasureInst::MeasureInst(const Program& c, Operand q_, Operand c_):
         Instruction(instruction_measure, c),
         q(q_),
         c(c_)
@@ -48,23 +57,19 @@ namespace kazm {
 
     std::string MeasureInst::str() {
         std::stringstream ss;
-
-        auto qb = caller->bstack[q];
-        auto cb = caller->bstack[c];
-
-        ss << "measure " << qb->name();
-        if (qb->isBit()) ss << "[" << dynamic_cast<Bit*>(qb.get())->index() << "]";
-
-        ss << " in " << cb->name();
-        if (cb->isBit()) ss << "[" << dynamic_cast<Bit*>(cb.get())->index() << "]";
-
+        ss << "measure " << caller->str(q) << " in " << caller->str(c);
         return ss.str();
     }
 
-    void MeasureInst::execute() {
+    std::size_t MeasureInst::lanes() const {
+        return caller->size(q);
     }
 
-    ResetInst::ResetInst(const Program& c, std::size_t q_):
+    void MeasureInst::execute(Backend& backend, std::size_t lane) const {
+        backend.measure(caller->offset(q)+lane, caller->offset(c)+lane);
+    }
+
+    ResetInst::ResetInst(const Program& c, Operand q_):
         Instruction(instruction_reset, c),
         q(q_)
     {
@@ -72,68 +77,61 @@ namespace kazm {
 
     std::string ResetInst::str() {
         std::stringstream ss;
-
-        auto qb = caller->bstack[q];
-
-        ss << "reset ";
-        if (qb->isReg()) ss << "register " << qb->name();
-        if (qb->isBit()) ss << "qubit " << qb->name() << "[" << dynamic_cast<Bit*>(qb.get())->index() << "]";
-
+        ss << "reset " << (q.broadcast() ? "register " : "qubit ") << caller->str(q);
         return ss.str();
     }
 
-    void ResetInst::execute() {
+    std::size_t ResetInst::lanes() const {
+        return caller->size(q);
     }
 
-    CallInst::CallInst(const Program& c, const std::shared_ptr<Gate>& g, const std::vector<std::size_t>& b):
-        Instruction(instruction_call, c),
-        gate(g)
-    {
-        for (const std::size_t& i : b) bits.push_back(i);
+    void ResetInst::execute(Backend& backend, std::size_t lane) const {
+        backend.reset(caller->offset(q)+lane);
     }
 
-    CallInst::CallInst(const Program& c, const std::shared_ptr<Gate>& g, const std::vector<std::size_t>& p, const std::vector<std::size_t>& b):
+    CallInst::CallInst(const Program& c, Gate* g, std::size_t p, std::size_t b):
         Instruction(instruction_call, c),
-        gate(g)
+        gate(g),
+        params(p),
+        bits(b)
     {
-        for (const std::size_t& i : b) bits.push_back(i);
-        for (const std::size_t& i : p) params.push_back(i);
     }
 
     std::string CallInst::str() {
         std::stringstream ss;
 
         ss << "call gate " << gate->name << " on ";
-        for (std::size_t i = 0; i < bits.size(); i++) {
-            auto qb = caller->bstack[bits[i]];
-            ss << qb->name();
-            try {
-                if (qb->isBit()) ss << "[" << dynamic_cast<Bit*>(qb.get())->index() << "]";
-            }
-            catch (const kazm::Exception& e) {
-            }
-            if (i != bits.size()-1) ss << ",";
+        for (std::size_t i = 0; i < gate->nqubits; i++) {
+            ss << caller->str(caller->operands[bits+i]);
+            if (i != gate->nqubits-1) ss << ",";
             ss << " ";
         }
 
-        if (params.size() == 0) return ss.str();
+        if (gate->nparams == 0) return ss.str();
 
         ss << "using parameters ";
-        for (std::size_t i = 0; i < params.size(); i++) {
-            auto p = caller->pstack[params[i]];
-            ss << p->str();
-            if (i != params.size()-1) ss << ",";
+        for (std::size_t i = 0; i < gate->nparams; i++) {
+            ss << caller->pstack[params+i]->str();
+            if (i != gate->nparams-1) ss << ",";
             ss << " ";
         }
 
         return ss.str();
     }
 
-    void CallInst::execute() {
-        gate->execute(*caller, params, bits);
+    std::size_t CallInst::lanes() const {
+        for (std::size_t i = 0; i < gate->nqubits; i++) {
+            Operand op = caller->operands[bits+i];
+            if (op.broadcast()) return caller->size(op);
+        }
+        return 1;
     }
 
-    IfInst::IfInst(const Program& c, std::size_t cr, const std::string& n, const std::shared_ptr<Instruction>& i):
+    void CallInst::execute(Backend& backend, std::size_t lane) const {
+        gate->execute(*caller, params, bits, lane, backend);
+    }
+
+    IfInst::IfInst(const Program& c, Operand cr, const std::string& n, Instruction* i):
         Instruction(instruction_if, c),
         creg(cr),
         num(n),
@@ -143,11 +141,20 @@ namespace kazm {
 
     std::string IfInst::str() {
         std::stringstream ss;
-        ss << inst->str() << " if " << caller->bstack[creg]->name() << " = " << num.str;
+        ss << inst->str() << " if " << caller->str(creg) << " = " << num.str;
         return ss.str();
     }
 
-    void IfInst::execute() {
+    std::size_t IfInst::lanes() const {
+        return inst->lanes();
+    }
+
+    void IfInst::execute(Backend&, std::size_t) const {
+        throw Exception("<Internal error IfInst::execute()> Conditional instructions must be expanded before execution");
+    }
+
+    bool IfInst::enter(Backend& backend) const {
+        return backend.beginConditional(caller->offset(creg), caller->size(creg), num);
     }
 
 }
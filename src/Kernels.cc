@@ -0,0 +1,482 @@
+#include <cmath>
+#include <vector>
+
+#include <Kernels.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KAZM_X86 1
+#endif
+
+namespace kazm {
+
+    static inline std::size_t insertZero(std::size_t k, std::size_t q) {
+        std::size_t mask = (std::size_t(1) << q) - 1;
+        return ((k & ~mask) << 1) | (k & mask);
+    }
+
+    static inline void pairScalar(double* a, std::size_t j0, std::size_t j1, const double* m) {
+        double* p0 = a + 2*j0;
+        double* p1 = a + 2*j1;
+        double a0r = p0[0];
+        double a0i = p0[1];
+        double a1r = p1[0];
+        double a1i = p1[1];
+        p0[0] = m[0]*a0r - m[1]*a0i + m[2]*a1r - m[3]*a1i;
+        p0[1] = m[0]*a0i + m[1]*a0r + m[2]*a1i + m[3]*a1r;
+        p1[0] = m[4]*a0r - m[5]*a0i + m[6]*a1r - m[7]*a1i;
+        p1[1] = m[4]*a0i + m[5]*a0r + m[6]*a1i + m[7]*a1r;
+    }
+
+    static void uScalar(double* a, std::size_t q, const double* m, std::size_t kb, std::size_t ke) {
+        std::size_t stride = std::size_t(1) << q;
+        for (std::size_t k = kb; k < ke; k++) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+        }
+    }
+
+    static inline std::size_t quadIndex(std::size_t k, std::size_t c, std::size_t t) {
+        std::size_t lo = c < t ? c : t;
+        std::size_t hi = c < t ? t : c;
+        return insertZero(insertZero(k, lo), hi) | (std::size_t(1) << c);
+    }
+
+    static void cxScalar(std::complex<double>* a, std::size_t c, std::size_t t, std::size_t kb, std::size_t ke) {
+        std::size_t tmask = std::size_t(1) << t;
+        for (std::size_t k = kb; k < ke; k++) {
+            std::size_t i = quadIndex(k, c, t);
+            std::swap(a[i], a[i | tmask]);
+        }
+    }
+
+    template <std::size_t K>
+    static void unitaryFixed(double* a, const std::size_t* sorted, const std::size_t* offsets, const double* matrix, std::size_t kb, std::size_t ke) {
+
+        const std::size_t dim = std::size_t(1) << K;
+        double vr[dim];
+        double vi[dim];
+        double m[2*dim*dim];
+        std::size_t off[dim];
+        std::size_t pos[K];
+
+        for (std::size_t i = 0; i < 2*dim*dim; i++) m[i] = matrix[i];
+        for (std::size_t i = 0; i < dim; i++) off[i] = offsets[i];
+        for (std::size_t i = 0; i < K; i++) pos[i] = sorted[i];
+
+        for (std::size_t g = kb; g < ke; g++) {
+            std::size_t base = g;
+            for (std::size_t i = 0; i < K; i++) base = insertZero(base, pos[i]);
+            for (std::size_t l = 0; l < dim; l++) {
+                vr[l] = a[2*(base + off[l])];
+                vi[l] = a[2*(base + off[l]) + 1];
+            }
+            for (std::size_t r = 0; r < dim; r++) {
+                const double* row = m + 2*r*dim;
+                double re = 0.0;
+                double im = 0.0;
+                for (std::size_t c = 0; c < dim; c++) {
+                    re += row[2*c]*vr[c] - row[2*c+1]*vi[c];
+                    im += row[2*c]*vi[c] + row[2*c+1]*vr[c];
+                }
+                a[2*(base + off[r])]     = re;
+                a[2*(base + off[r]) + 1] = im;
+            }
+        }
+    }
+
+    static void unitaryScalar(double* a, std::size_t k, const std::size_t* sorted, const std::size_t* offsets, const double* m, std::size_t kb, std::size_t ke) {
+
+        std::size_t dim = std::size_t(1) << k;
+        std::vector<double> vr(dim);
+        std::vector<double> vi(dim);
+
+        for (std::size_t g = kb; g < ke; g++) {
+            std::size_t base = g;
+            for (std::size_t i = 0; i < k; i++) base = insertZero(base, sorted[i]);
+            for (std::size_t l = 0; l < dim; l++) {
+                vr[l] = a[2*(base + offsets[l])];
+                vi[l] = a[2*(base + offsets[l]) + 1];
+            }
+            for (std::size_t r = 0; r < dim; r++) {
+                const double* row = m + 2*r*dim;
+                double re = 0.0;
+                double im = 0.0;
+                for (std::size_t c = 0; c < dim; c++) {
+                    re += row[2*c]*vr[c] - row[2*c+1]*vi[c];
+                    im += row[2*c]*vi[c] + row[2*c+1]*vr[c];
+                }
+                a[2*(base + offsets[r])]     = re;
+                a[2*(base + offsets[r]) + 1] = im;
+            }
+        }
+    }
+
+#ifdef KAZM_X86
+
+    __attribute__((target("avx2,fma")))
+    static inline __m256d cmul2(__m256d mr, __m256d mi, __m256d v) {
+        return _mm256_fmaddsub_pd(mr, v, _mm256_mul_pd(mi, _mm256_permute_pd(v, 0x5)));
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void uAVX2High(double* a, std::size_t q, const double* m, std::size_t kb, std::size_t ke) {
+
+        std::size_t stride = std::size_t(1) << q;
+
+        __m256d m00r = _mm256_set1_pd(m[0]);
+        __m256d m00i = _mm256_set1_pd(m[1]);
+        __m256d m01r = _mm256_set1_pd(m[2]);
+        __m256d m01i = _mm256_set1_pd(m[3]);
+        __m256d m10r = _mm256_set1_pd(m[4]);
+        __m256d m10i = _mm256_set1_pd(m[5]);
+        __m256d m11r = _mm256_set1_pd(m[6]);
+        __m256d m11i = _mm256_set1_pd(m[7]);
+
+        std::size_t k = kb;
+        if (k % 2 != 0 && k < ke) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+            k++;
+        }
+        for (; k+2 <= ke; k += 2) {
+            std::size_t j = insertZero(k, q);
+            double* p0 = a + 2*j;
+            double* p1 = a + 2*(j+stride);
+            __m256d a0 = _mm256_loadu_pd(p0);
+            __m256d a1 = _mm256_loadu_pd(p1);
+            _mm256_storeu_pd(p0, _mm256_add_pd(cmul2(m00r, m00i, a0), cmul2(m01r, m01i, a1)));
+            _mm256_storeu_pd(p1, _mm256_add_pd(cmul2(m10r, m10i, a0), cmul2(m11r, m11i, a1)));
+        }
+        if (k < ke) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void uAVX2Low(double* a, const double* m, std::size_t kb, std::size_t ke) {
+
+        __m256d c0r = _mm256_setr_pd(m[0], m[0], m[4], m[4]);
+        __m256d c0i = _mm256_setr_pd(m[1], m[1], m[5], m[5]);
+        __m256d c1r = _mm256_setr_pd(m[2], m[2], m[6], m[6]);
+        __m256d c1i = _mm256_setr_pd(m[3], m[3], m[7], m[7]);
+
+        for (std::size_t k = kb; k < ke; k++) {
+            double* p = a + 4*k;
+            __m256d v  = _mm256_loadu_pd(p);
+            __m256d lo = _mm256_permute2f128_pd(v, v, 0x00);
+            __m256d hi = _mm256_permute2f128_pd(v, v, 0x11);
+            _mm256_storeu_pd(p, _mm256_add_pd(cmul2(c0r, c0i, lo), cmul2(c1r, c1i, hi)));
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void cxAVX2(std::complex<double>* amp, std::size_t c, std::size_t t, std::size_t kb, std::size_t ke) {
+
+        double* a = reinterpret_cast<double*>(amp);
+        std::size_t tmask = std::size_t(1) << t;
+
+        if (t == 0) {
+            for (std::size_t k = kb; k < ke; k++) {
+                double* p = a + 2*quadIndex(k, c, t);
+                __m256d v = _mm256_loadu_pd(p);
+                _mm256_storeu_pd(p, _mm256_permute2f128_pd(v, v, 0x01));
+            }
+        }
+        else if (c == 0) {
+            for (std::size_t k = kb; k < ke; k++) {
+                std::size_t i = quadIndex(k, c, t) - 1;
+                double* p0 = a + 2*i;
+                double* p1 = a + 2*(i | tmask);
+                __m256d v0 = _mm256_loadu_pd(p0);
+                __m256d v1 = _mm256_loadu_pd(p1);
+                _mm256_storeu_pd(p0, _mm256_blend_pd(v0, v1, 0xC));
+                _mm256_storeu_pd(p1, _mm256_blend_pd(v1, v0, 0xC));
+            }
+        }
+        else {
+            std::size_t k = kb;
+            if (k % 2 != 0 && k < ke) cxScalar(amp, c, t, k, k+1), k++;
+            for (; k+2 <= ke; k += 2) {
+                std::size_t i = quadIndex(k, c, t);
+                double* p0 = a + 2*i;
+                double* p1 = a + 2*(i | tmask);
+                __m256d v0 = _mm256_loadu_pd(p0);
+                __m256d v1 = _mm256_loadu_pd(p1);
+                _mm256_storeu_pd(p0, v1);
+                _mm256_storeu_pd(p1, v0);
+            }
+            if (k < ke) cxScalar(amp, c, t, k, ke);
+        }
+    }
+
+    template <std::size_t K>
+    __attribute__((target("avx2,fma")))
+    static void unitaryAVX2(double* a, const std::size_t* sorted, const std::size_t* offsets, const double* matrix, std::size_t kb, std::size_t ke) {
+
+        const std::size_t dim = std::size_t(1) << K;
+        double m[2*dim*dim];
+        std::size_t off[dim];
+        std::size_t pos[K];
+        __m256d v[dim];
+
+        for (std::size_t i = 0; i < 2*dim*dim; i++) m[i] = matrix[i];
+        for (std::size_t i = 0; i < dim; i++) off[i] = offsets[i];
+        for (std::size_t i = 0; i < K; i++) pos[i] = sorted[i];
+
+        std::size_t g = kb;
+        if (g % 2 != 0 && g < ke) unitaryFixed<K>(a, sorted, offsets, matrix, g, g+1), g++;
+        for (; g+2 <= ke; g += 2) {
+            std::size_t base = g;
+            for (std::size_t i = 0; i < K; i++) base = insertZero(base, pos[i]);
+            for (std::size_t l = 0; l < dim; l++) v[l] = _mm256_loadu_pd(a + 2*(base + off[l]));
+            for (std::size_t r = 0; r < dim; r++) {
+                const double* row = m + 2*r*dim;
+                __m256d re = _mm256_setzero_pd();
+                __m256d im = _mm256_setzero_pd();
+                for (std::size_t c = 0; c < dim; c++) {
+                    re = _mm256_fmadd_pd(_mm256_broadcast_sd(row + 2*c), v[c], re);
+                    im = _mm256_fmadd_pd(_mm256_broadcast_sd(row + 2*c + 1), _mm256_permute_pd(v[c], 0x5), im);
+                }
+                _mm256_storeu_pd(a + 2*(base + off[r]), _mm256_addsub_pd(re, im));
+            }
+        }
+        if (g < ke) unitaryFixed<K>(a, sorted, offsets, matrix, g, ke);
+    }
+
+    template <std::size_t K>
+    __attribute__((target("avx512f")))
+    static void unitaryAVX512(double* a, const std::size_t* sorted, const std::size_t* offsets, const double* matrix, std::size_t kb, std::size_t ke) {
+
+        const std::size_t dim = std::size_t(1) << K;
+        double m[2*dim*dim];
+        std::size_t off[dim];
+        std::size_t pos[K];
+        __m512d v[dim];
+
+        for (std::size_t i = 0; i < 2*dim*dim; i++) m[i] = matrix[i];
+        for (std::size_t i = 0; i < dim; i++) off[i] = offsets[i];
+        for (std::size_t i = 0; i < K; i++) pos[i] = sorted[i];
+
+        std::size_t g = kb;
+        for (; g % 4 != 0 && g < ke; g++) unitaryFixed<K>(a, sorted, offsets, matrix, g, g+1);
+        for (; g+4 <= ke; g += 4) {
+            std::size_t base = g;
+            for (std::size_t i = 0; i < K; i++) base = insertZero(base, pos[i]);
+            for (std::size_t l = 0; l < dim; l++) v[l] = _mm512_loadu_pd(a + 2*(base + off[l]));
+            for (std::size_t r = 0; r < dim; r++) {
+                const double* row = m + 2*r*dim;
+                __m512d re = _mm512_setzero_pd();
+                __m512d im = _mm512_setzero_pd();
+                for (std::size_t c = 0; c < dim; c++) {
+                    re = _mm512_fmadd_pd(_mm512_set1_pd(row[2*c]), v[c], re);
+                    im = _mm512_fmadd_pd(_mm512_set1_pd(row[2*c+1]), _mm512_permute_pd(v[c], 0x55), im);
+                }
+                _mm512_storeu_pd(a + 2*(base + off[r]), _mm512_fmaddsub_pd(_mm512_set1_pd(1.0), re, im));
+            }
+        }
+        if (g < ke) unitaryFixed<K>(a, sorted, offsets, matrix, g, ke);
+    }
+
+    __attribute__((target("avx512f")))
+    static inline __m512d cmul4(__m512d mr, __m512d mi, __m512d v) {
+        return _mm512_fmaddsub_pd(mr, v, _mm512_mul_pd(mi, _mm512_permute_pd(v, 0x55)));
+    }
+
+    __attribute__((target("avx512f")))
+    static void uAVX512High(double* a, std::size_t q, const double* m, std::size_t kb, std::size_t ke) {
+
+        std::size_t stride = std::size_t(1) << q;
+
+        __m512d m00r = _mm512_set1_pd(m[0]);
+        __m512d m00i = _mm512_set1_pd(m[1]);
+        __m512d m01r = _mm512_set1_pd(m[2]);
+        __m512d m01i = _mm512_set1_pd(m[3]);
+        __m512d m10r = _mm512_set1_pd(m[4]);
+        __m512d m10i = _mm512_set1_pd(m[5]);
+        __m512d m11r = _mm512_set1_pd(m[6]);
+        __m512d m11i = _mm512_set1_pd(m[7]);
+
+        std::size_t k = kb;
+        for (; k % 4 != 0 && k < ke; k++) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+        }
+        for (; k+4 <= ke; k += 4) {
+            std::size_t j = insertZero(k, q);
+            double* p0 = a + 2*j;
+            double* p1 = a + 2*(j+stride);
+            __m512d a0 = _mm512_loadu_pd(p0);
+            __m512d a1 = _mm512_loadu_pd(p1);
+            _mm512_storeu_pd(p0, _mm512_add_pd(cmul4(m00r, m00i, a0), cmul4(m01r, m01i, a1)));
+            _mm512_storeu_pd(p1, _mm512_add_pd(cmul4(m10r, m10i, a0), cmul4(m11r, m11i, a1)));
+        }
+        for (; k < ke; k++) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void uAVX512Low(double* a, std::size_t q, const double* m, std::size_t kb, std::size_t ke) {
+
+        __m512i ilo;
+        __m512i ihi;
+        double cr[2][8];
+        double ci[2][8];
+
+        for (std::size_t l = 0; l < 4; l++) {
+            std::size_t row = q == 0 ? l % 2 : l / 2;
+            for (std::size_t col = 0; col < 2; col++) {
+                cr[col][2*l] = cr[col][2*l+1] = m[4*row + 2*col];
+                ci[col][2*l] = ci[col][2*l+1] = m[4*row + 2*col + 1];
+            }
+        }
+        if (q == 0) {
+            ilo = _mm512_setr_epi64(0, 1, 0, 1, 4, 5, 4, 5);
+            ihi = _mm512_setr_epi64(2, 3, 2, 3, 6, 7, 6, 7);
+        }
+        else {
+            ilo = _mm512_setr_epi64(0, 1, 2, 3, 0, 1, 2, 3);
+            ihi = _mm512_setr_epi64(4, 5, 6, 7, 4, 5, 6, 7);
+        }
+
+        __m512d c0r = _mm512_loadu_pd(cr[0]);
+        __m512d c0i = _mm512_loadu_pd(ci[0]);
+        __m512d c1r = _mm512_loadu_pd(cr[1]);
+        __m512d c1i = _mm512_loadu_pd(ci[1]);
+
+        std::size_t stride = std::size_t(1) << q;
+        std::size_t k = kb;
+        if (k % 2 != 0 && k < ke) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+            k++;
+        }
+        for (; k+2 <= ke; k += 2) {
+            double* p = a + 4*k;
+            __m512d v  = _mm512_loadu_pd(p);
+            __m512d lo = _mm512_permutexvar_pd(ilo, v);
+            __m512d hi = _mm512_permutexvar_pd(ihi, v);
+            _mm512_storeu_pd(p, _mm512_add_pd(cmul4(c0r, c0i, lo), cmul4(c1r, c1i, hi)));
+        }
+        if (k < ke) {
+            std::size_t j = insertZero(k, q);
+            pairScalar(a, j, j+stride, m);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void cxAVX512(std::complex<double>* amp, std::size_t c, std::size_t t, std::size_t kb, std::size_t ke) {
+
+        double* a = reinterpret_cast<double*>(amp);
+        std::size_t tmask = std::size_t(1) << t;
+
+        std::size_t k = kb;
+        for (; k % 4 != 0 && k < ke; k++) cxScalar(amp, c, t, k, k+1);
+        for (; k+4 <= ke; k += 4) {
+            std::size_t i = quadIndex(k, c, t);
+            double* p0 = a + 2*i;
+            double* p1 = a + 2*(i | tmask);
+            __m512d v0 = _mm512_loadu_pd(p0);
+            __m512d v1 = _mm512_loadu_pd(p1);
+            _mm512_storeu_pd(p0, v1);
+            _mm512_storeu_pd(p1, v0);
+        }
+        if (k < ke) cxScalar(amp, c, t, k, ke);
+    }
+
+#endif
+
+    KernelType Kernels::Detect() {
+#ifdef KAZM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return kernel_avx512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return kernel_avx2;
+#endif
+        return kernel_scalar;
+    }
+
+    KernelType Kernels::GetType(const std::string& s) throw (Exception) {
+
+        KernelType k = kernel_scalar;
+        if (s == "scalar") k = kernel_scalar;
+        else if (s == "avx2") k = kernel_avx2;
+        else if (s == "avx512") k = kernel_avx512;
+        else throw Exception("Unknown kernel " + s);
+
+        if (k > Detect()) throw Exception("Kernel " + s + " is not supported on this CPU");
+        return k;
+    }
+
+    std::string Kernels::GetName(KernelType k) {
+        if (k == kernel_avx512) return "avx512";
+        if (k == kernel_avx2) return "avx2";
+        return "scalar";
+    }
+
+    void Kernels::UMatrix(double theta, double phi, double lambda, double* m) {
+
+        double c = cos(theta/2.0);
+        double s = sin(theta/2.0);
+
+        m[0] = c;
+        m[1] = 0.0;
+        m[2] = -cos(lambda) * s;
+        m[3] = -sin(lambda) * s;
+        m[4] = cos(phi) * s;
+        m[5] = sin(phi) * s;
+        m[6] = cos(phi+lambda) * c;
+        m[7] = sin(phi+lambda) * c;
+    }
+
+    void Kernels::ApplyU(KernelType k, std::complex<double>* amp, std::size_t q, const double* m, std::size_t kb, std::size_t ke) {
+
+        double* a = reinterpret_cast<double*>(amp);
+
+#ifdef KAZM_X86
+        if (k == kernel_avx512 && q >= 2) return uAVX512High(a, q, m, kb, ke);
+        if (k == kernel_avx512) return uAVX512Low(a, q, m, kb, ke);
+        if (k == kernel_avx2 && q >= 1) return uAVX2High(a, q, m, kb, ke);
+        if (k == kernel_avx2) return uAVX2Low(a, m, kb, ke);
+#endif
+        uScalar(a, q, m, kb, ke);
+    }
+
+    void Kernels::ApplyUnitary(KernelType kt, std::complex<double>* amp, std::size_t k, const std::size_t* sorted, const std::size_t* offsets, const std::complex<double>* matrix, std::size_t kb, std::size_t ke) {
+
+        double* a = reinterpret_cast<double*>(amp);
+        const double* m = reinterpret_cast<const double*>(matrix);
+
+#ifdef KAZM_X86
+        if (kt == kernel_avx512 && sorted[0] >= 2) {
+            if      (k == 2) return unitaryAVX512<2>(a, sorted, offsets, m, kb, ke);
+            else if (k == 3) return unitaryAVX512<3>(a, sorted, offsets, m, kb, ke);
+            else if (k == 4) return unitaryAVX512<4>(a, sorted, offsets, m, kb, ke);
+            else if (k == 5) return unitaryAVX512<5>(a, sorted, offsets, m, kb, ke);
+        }
+        if (kt >= kernel_avx2 && sorted[0] >= 1) {
+            if      (k == 2) return unitaryAVX2<2>(a, sorted, offsets, m, kb, ke);
+            else if (k == 3) return unitaryAVX2<3>(a, sorted, offsets, m, kb, ke);
+            else if (k == 4) return unitaryAVX2<4>(a, sorted, offsets, m, kb, ke);
+            else if (k == 5) return unitaryAVX2<5>(a, sorted, offsets, m, kb, ke);
+        }
+#endif
+        if      (k == 2) unitaryFixed<2>(a, sorted, offsets, m, kb, ke);
+        else if (k == 3) unitaryFixed<3>(a, sorted, offsets, m, kb, ke);
+        else if (k == 4) unitaryFixed<4>(a, sorted, offsets, m, kb, ke);
+        else if (k == 5) unitaryFixed<5>(a, sorted, offsets, m, kb, ke);
+        else unitaryScalar(a, k, sorted, offsets, m, kb, ke);
+    }
+
+    void Kernels::ApplyCX(KernelType k, std::complex<double>* amp, std::size_t c, std::size_t t, std::size_t kb, std::size_t ke) {
+
+#ifdef KAZM_X86
+        if (k == kernel_avx512 && c >= 2 && t >= 2) return cxAVX512(amp, c, t, kb, ke);
+        if (k >= kernel_avx2) return cxAVX2(amp, c, t, kb, ke);
+#endif
+        cxScalar(amp, c, t, kb, ke);
+    }
+
+}
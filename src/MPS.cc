@@ -0,0 +1,438 @@
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+#ifdef KAZM_BLAS
+#include <cblas.h>
+#endif
+
+#include <MPS.h>
+#include <Kernels.h>
+
+namespace kazm {
+
+    static const std::size_t block = 32;
+    static const std::size_t max_sweeps = 64;
+    static const double precision = 1e-14;
+    static const double cutoff = 1e-15;
+
+    static const unsigned swap_gate[4] = {0, 2, 1, 3};
+    static const unsigned cx_left[4] = {0, 1, 3, 2};
+    static const unsigned cx_right[4] = {0, 3, 2, 1};
+
+    MPS::MPS(std::size_t nq, std::size_t nc, std::size_t b):
+        Backend(nq, nc),
+        bond(b),
+        center(0),
+        sites(nq),
+        truncation(0.0),
+        max_truncation(0.0),
+        max_bond(1)
+    {
+        init();
+    }
+
+    void MPS::init() {
+
+        Backend::init();
+
+        for (Site& site : sites) {
+            site.left = 1;
+            site.right = 1;
+            site.data.assign(2, 0.0);
+            site.data[0] = 1.0;
+        }
+        center = 0;
+        truncation = 0.0;
+    }
+
+    void MPS::assign(const MPS& other) {
+        sites = other.sites;
+        center = other.center;
+        truncation = other.truncation;
+        clbits = other.clbits;
+    }
+
+    void MPS::u(std::size_t q, double theta, double phi, double lambda) {
+
+        double m[8];
+        Kernels::UMatrix(theta, phi, lambda, m);
+
+        Site& site = sites[q];
+        double* a = reinterpret_cast<double*>(site.data.data());
+        std::size_t stride = 2*site.right;
+        for (std::size_t l = 0; l < site.left; l++) {
+            double* a0 = a + 2*l*stride;
+            double* a1 = a0 + stride;
+            for (std::size_t r = 0; r < stride; r += 2) {
+                double xr = a0[r], xi = a0[r+1], yr = a1[r], yi = a1[r+1];
+                a0[r]   = m[0]*xr - m[1]*xi + m[2]*yr - m[3]*yi;
+                a0[r+1] = m[0]*xi + m[1]*xr + m[2]*yi + m[3]*yr;
+                a1[r]   = m[4]*xr - m[5]*xi + m[6]*yr - m[7]*yi;
+                a1[r+1] = m[4]*xi + m[5]*xr + m[6]*yi + m[7]*yr;
+            }
+        }
+    }
+
+    void MPS::cx(std::size_t c, std::size_t t) {
+
+        if (c < t) {
+            for (std::size_t k = c; k+1 < t; k++) apply(k, swap_gate, true);
+            apply(t-1, cx_left, t-1 == c);
+            for (std::size_t k = t-1; k-- > c; ) apply(k, swap_gate, false);
+        }
+        else {
+            for (std::size_t k = c-1; k > t; k--) apply(k, swap_gate, false);
+            apply(t, cx_right, true);
+            for (std::size_t k = t+1; k < c; k++) apply(k, swap_gate, true);
+        }
+    }
+
+    void MPS::apply(std::size_t k, const unsigned* gate, bool forward) {
+
+        if (center > k+1) move(k+1);
+        else if (center < k) move(k);
+
+        Site& a = sites[k];
+        Site& b = sites[k+1];
+        std::size_t m = 2*a.left;
+        std::size_t n = 2*b.right;
+
+        std::vector<std::complex<double> > theta(m*n);
+        std::vector<std::complex<double> > permuted(m*n);
+        Multiply(m, a.right, n, a.data.data(), b.data.data(), theta.data());
+
+        for (std::size_t l = 0; l < a.left; l++) {
+            for (unsigned p = 0; p < 4; p++) {
+                const std::complex<double>* src = &theta[(2*l + (gate[p] >> 1))*n + (gate[p] & 1)*b.right];
+                std::complex<double>* dst = &permuted[(2*l + (p >> 1))*n + (p & 1)*b.right];
+                std::copy(src, src + b.right, dst);
+            }
+        }
+
+        std::vector<std::complex<double> > left, right;
+        std::vector<double> values;
+        Decompose(m, n, permuted.data(), left, values, right);
+
+        double scale;
+        std::size_t rank = values.size();
+        std::size_t r = truncate(values, bond, scale);
+
+        a.right = r;
+        a.data.resize(m*r);
+        for (std::size_t i = 0; i < m; i++) {
+            for (std::size_t j = 0; j < r; j++) a.data[i*r + j] = left[i*rank + j] * (forward ? 1.0 : values[j] * scale);
+        }
+
+        b.left = r;
+        b.data.resize(r*n);
+        for (std::size_t j = 0; j < r; j++) {
+            double s = forward ? values[j] * scale : 1.0;
+            for (std::size_t i = 0; i < n; i++) b.data[j*n + i] = s * right[j*n + i];
+        }
+
+        center = forward ? k+1 : k;
+        max_bond = std::max(max_bond, r);
+    }
+
+    void MPS::move(std::size_t k) {
+
+        std::vector<std::complex<double> > left, right, product;
+        std::vector<double> values;
+        double scale;
+
+        while (center < k) {
+            Site& a = sites[center];
+            Site& b = sites[center+1];
+            std::size_t m = 2*a.left;
+            std::size_t n = a.right;
+            Decompose(m, n, a.data.data(), left, values, right);
+            std::size_t rank = values.size();
+            std::size_t r = truncate(values, rank, scale);
+
+            a.right = r;
+            a.data.resize(m*r);
+            for (std::size_t i = 0; i < m; i++) {
+                std::copy(&left[i*rank], &left[i*rank] + r, &a.data[i*r]);
+            }
+            for (std::size_t j = 0; j < r; j++) {
+                for (std::size_t i = 0; i < n; i++) right[j*n + i] *= values[j] * scale;
+            }
+
+            product.resize(r * 2*b.right);
+            Multiply(r, n, 2*b.right, right.data(), b.data.data(), product.data());
+            b.left = r;
+            b.data.swap(product);
+            center++;
+        }
+
+        while (center > k) {
+            Site& a = sites[center-1];
+            Site& b = sites[center];
+            std::size_t m = b.left;
+            std::size_t n = 2*b.right;
+            Decompose(m, n, b.data.data(), left, values, right);
+            std::size_t rank = values.size();
+            std::size_t r = truncate(values, rank, scale);
+
+            b.left = r;
+            b.data.assign(right.begin(), right.begin() + r*n);
+            for (std::size_t i = 0; i < m; i++) {
+                for (std::size_t j = 0; j < r; j++) left[i*r + j] = left[i*rank + j] * (values[j] * scale);
+            }
+
+            product.resize(2*a.left * r);
+            Multiply(2*a.left, m, r, a.data.data(), left.data(), product.data());
+            a.right = r;
+            a.data.swap(product);
+            center--;
+        }
+    }
+
+    std::size_t MPS::truncate(const std::vector<double>& values, std::size_t limit, double& scale) {
+
+        double total = 0.0;
+        for (double s : values) total += s*s;
+
+        double kept = 0.0;
+        std::size_t r = 0;
+        while (r < values.size() && r < limit && values[r]*values[r] > cutoff*total) {
+            kept += values[r]*values[r];
+            r++;
+        }
+
+        truncation = 1.0 - (1.0 - truncation) * kept / total;
+        max_truncation = std::max(max_truncation, truncation);
+        scale = 1.0 / std::sqrt(kept);
+        return r;
+    }
+
+    void MPS::flip(std::size_t q) {
+        Site& site = sites[q];
+        for (std::size_t l = 0; l < site.left; l++) {
+            auto row = site.data.begin() + 2*l*site.right;
+            std::swap_ranges(row, row + site.right, row + site.right);
+        }
+    }
+
+    bool MPS::sample(std::size_t q) {
+
+        move(q);
+
+        Site& site = sites[q];
+        double w[2] = {0.0, 0.0};
+        for (std::size_t l = 0; l < site.left; l++) {
+            for (unsigned s = 0; s < 2; s++) {
+                for (std::size_t r = 0; r < site.right; r++) w[s] += std::norm(site.data[(2*l + s)*site.right + r]);
+            }
+        }
+
+        bool outcome = random() < w[1] / (w[0] + w[1]);
+        double scale = 1.0 / std::sqrt(w[outcome]);
+        for (std::size_t l = 0; l < site.left; l++) {
+            auto keep = site.data.begin() + (2*l + outcome)*site.right;
+            auto drop = site.data.begin() + (2*l + !outcome)*site.right;
+            for (auto it = keep; it != keep + site.right; ++it) *it *= scale;
+            std::fill(drop, drop + site.right, 0.0);
+        }
+        return outcome;
+    }
+
+    void MPS::draw(const MPS& state, std::size_t count, std::vector<uint8_t>& bits) {
+
+        std::vector<std::complex<double> > env(1, 1.0);
+        std::vector<std::complex<double> > next[2];
+        bits.resize(count);
+
+        for (std::size_t q = 0; q < count; q++) {
+            const Site& site = state.sites[q];
+            double w[2];
+            for (unsigned s = 0; s < 2; s++) {
+                next[s].assign(site.right, 0.0);
+                const double* pe = reinterpret_cast<const double*>(env.data());
+                const double* pa = reinterpret_cast<const double*>(site.data.data());
+                double* pn = reinterpret_cast<double*>(next[s].data());
+                for (std::size_t l = 0; l < site.left; l++) {
+                    double er = pe[2*l], ei = pe[2*l+1];
+                    const double* row = pa + 2*(2*l + s)*site.right;
+                    for (std::size_t r = 0; r < 2*site.right; r += 2) {
+                        pn[r]   += er*row[r] - ei*row[r+1];
+                        pn[r+1] += er*row[r+1] + ei*row[r];
+                    }
+                }
+                w[s] = 0.0;
+                for (const std::complex<double>& c : next[s]) w[s] += std::norm(c);
+            }
+
+            bool outcome = random() < w[1] / (w[0] + w[1]);
+            double scale = 1.0 / std::sqrt(w[outcome]);
+            env.resize(site.right);
+            for (std::size_t r = 0; r < site.right; r++) env[r] = next[outcome][r] * scale;
+            bits[q] = outcome;
+        }
+    }
+
+    void MPS::measure(std::size_t q, std::size_t c) {
+        setClbit(c, sample(q));
+    }
+
+    void MPS::reset(std::size_t q) {
+        if (sample(q)) flip(q);
+    }
+
+    void MPS::Multiply(std::size_t m, std::size_t k, std::size_t n, const std::complex<double>* a, const std::complex<double>* b, std::complex<double>* c) {
+
+#ifdef KAZM_BLAS
+        const std::complex<double> one(1.0), zero(0.0);
+        cblas_zgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, &one, a, k, b, n, &zero, c, n);
+#else
+        const double* pa = reinterpret_cast<const double*>(a);
+        const double* pb = reinterpret_cast<const double*>(b);
+        double* pc = reinterpret_cast<double*>(c);
+
+        std::fill(pc, pc + 2*m*n, 0.0);
+
+        for (std::size_t i0 = 0; i0 < m; i0 += block) {
+            std::size_t i1 = std::min(i0 + block, m);
+            for (std::size_t p0 = 0; p0 < k; p0 += block) {
+                std::size_t p1 = std::min(p0 + block, k);
+                for (std::size_t j0 = 0; j0 < n; j0 += block) {
+                    std::size_t j1 = std::min(j0 + block, n);
+                    for (std::size_t i = i0; i < i1; i++) {
+                        double* ci = pc + 2*i*n;
+                        for (std::size_t p = p0; p < p1; p++) {
+                            double ar = pa[2*(i*k + p)];
+                            double ai = pa[2*(i*k + p) + 1];
+                            const double* bp = pb + 2*p*n;
+                            for (std::size_t j = j0; j < j1; j++) {
+                                double br = bp[2*j], bi = bp[2*j+1];
+                                ci[2*j]   += ar*br - ai*bi;
+                                ci[2*j+1] += ar*bi + ai*br;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    void MPS::Orthogonalize(std::size_t len, std::size_t cols, double* w, double* v) {
+
+        std::vector<double> norms(cols);
+
+        for (std::size_t sweep = 0; sweep < max_sweeps; sweep++) {
+            for (std::size_t j = 0; j < cols; j++) {
+                const double* wj = w + 2*j*len;
+                double sum = 0.0;
+                for (std::size_t k = 0; k < 2*len; k++) sum += wj[k]*wj[k];
+                norms[j] = sum;
+            }
+
+            bool rotated = false;
+            for (std::size_t i = 0; i < cols; i++) {
+                for (std::size_t j = i+1; j < cols; j++) {
+                    double* wi = w + 2*i*len;
+                    double* wj = w + 2*j*len;
+
+                    double pr[4] = {0.0, 0.0, 0.0, 0.0};
+                    double pi[4] = {0.0, 0.0, 0.0, 0.0};
+                    std::size_t k = 0;
+                    for (; k + 4 <= 2*len; k += 4) {
+                        for (unsigned b = 0; b < 4; b++) pr[b] += wi[k+b]*wj[k+b];
+                        for (unsigned b = 0; b < 4; b++) pi[b] += wi[k+b]*wj[k+(b^1)];
+                    }
+                    for (; k < 2*len; k += 2) {
+                        pr[0] += wi[k]*wj[k] + wi[k+1]*wj[k+1];
+                        pi[0] += wi[k]*wj[k+1];
+                        pi[1] += wi[k+1]*wj[k];
+                    }
+                    double gr = (pr[0] + pr[1]) + (pr[2] + pr[3]);
+                    double gi = (pi[0] - pi[1]) + (pi[2] - pi[3]);
+
+                    double alpha = norms[i], beta = norms[j];
+                    double g = std::hypot(gr, gi);
+                    if (g == 0.0 || g <= precision * std::sqrt(alpha*beta)) continue;
+                    rotated = true;
+
+                    double zeta = (beta - alpha) / (2.0*g);
+                    double t = (zeta >= 0.0 ? 1.0 : -1.0) / (std::fabs(zeta) + std::sqrt(1.0 + zeta*zeta));
+                    double c = 1.0 / std::sqrt(1.0 + t*t);
+                    double s = c*t;
+                    double er = gr/g, ei = -gi/g;
+                    norms[i] = alpha - t*g;
+                    norms[j] = beta + t*g;
+
+                    for (std::size_t k = 0; k < 2*len; k += 2) {
+                        double xr = wi[k], xi = wi[k+1];
+                        double yr = er*wj[k] - ei*wj[k+1];
+                        double yi = er*wj[k+1] + ei*wj[k];
+                        wi[k]   = c*xr - s*yr;
+                        wi[k+1] = c*xi - s*yi;
+                        wj[k]   = s*xr + c*yr;
+                        wj[k+1] = s*xi + c*yi;
+                    }
+
+                    double* vi = v + 2*i*cols;
+                    double* vj = v + 2*j*cols;
+                    for (std::size_t k = 0; k < 2*cols; k += 2) {
+                        double xr = vi[k], xi = vi[k+1];
+                        double yr = er*vj[k] - ei*vj[k+1];
+                        double yi = er*vj[k+1] + ei*vj[k];
+                        vi[k]   = c*xr - s*yr;
+                        vi[k+1] = c*xi - s*yi;
+                        vj[k]   = s*xr + c*yr;
+                        vj[k+1] = s*xi + c*yi;
+                    }
+                }
+            }
+            if (!rotated) break;
+        }
+    }
+
+    void MPS::Decompose(std::size_t m, std::size_t n, const std::complex<double>* a, std::vector<std::complex<double> >& u, std::vector<double>& s, std::vector<std::complex<double> >& vh) {
+
+        bool wide = n > m;
+        std::size_t len = wide ? n : m;
+        std::size_t cols = wide ? m : n;
+
+        std::vector<std::complex<double> > w(len*cols);
+        std::vector<std::complex<double> > v(cols*cols, 0.0);
+        for (std::size_t i = 0; i < m; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                if (wide) w[i*n + j] = std::conj(a[i*n + j]);
+                else w[j*m + i] = a[i*n + j];
+            }
+        }
+        for (std::size_t j = 0; j < cols; j++) v[j*cols + j] = 1.0;
+
+        Orthogonalize(len, cols, reinterpret_cast<double*>(w.data()), reinterpret_cast<double*>(v.data()));
+
+        std::vector<double> norms(cols, 0.0);
+        for (std::size_t j = 0; j < cols; j++) {
+            for (std::size_t i = 0; i < len; i++) norms[j] += std::norm(w[j*len + i]);
+            norms[j] = std::sqrt(norms[j]);
+        }
+        std::vector<std::size_t> order(cols);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) { return norms[x] > norms[y]; });
+
+        s.resize(cols);
+        u.resize(m*cols);
+        vh.resize(cols*n);
+        for (std::size_t k = 0; k < cols; k++) {
+            std::size_t j = order[k];
+            double inv = norms[j] > 0.0 ? 1.0 / norms[j] : 0.0;
+            s[k] = norms[j];
+            if (wide) {
+                for (std::size_t i = 0; i < m; i++) u[i*cols + k] = v[j*cols + i];
+                for (std::size_t i = 0; i < n; i++) vh[k*n + i] = std::conj(w[j*n + i]) * inv;
+            }
+            else {
+                for (std::size_t i = 0; i < m; i++) u[i*cols + k] = w[j*m + i] * inv;
+                for (std::size_t i = 0; i < n; i++) vh[k*n + i] = std::conj(v[j*cols + i]);
+            }
+        }
+    }
+
+}
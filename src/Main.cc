@@ -1,21 +1,292 @@
 #include <memory>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cstdlib>
+#include <cerrno>
+#include <thread>
+#include <chrono>
 
 #include <Parser.h>
+#include <IR.h>
+#include <Simulator.h>
+#include <Fusion.h>
+#include <ThreadPool.h>
+#include <Trajectories.h>
+#include <Kernels.h>
 #include <Exception.h>
 
+static uint64_t parseNumber(int& i, int argc, char* argv[]) {
+
+    std::string option = argv[i];
+    if (++i == argc) throw kazm::Exception("Expect a number after " + option);
+
+    std::string value = argv[i];
+    char* end = nullptr;
+    errno = 0;
+    uint64_t n = strtoull(value.c_str(), &end, 0);
+    if (value.empty() || *end != '\0' || errno == ERANGE) throw kazm::Exception("Invalid value " + value + " for " + option);
+    return n;
+}
+
+static std::vector<std::vector<double> > readSweep(const std::string& filename) {
+
+    std::ifstream in(filename);
+    if (!in) throw kazm::Exception("Unable to open parameter file " + filename);
+
+    std::vector<std::vector<double> > sets;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::vector<double> values;
+        std::string value;
+        while (ss >> value) {
+            char* end = nullptr;
+            errno = 0;
+            double d = strtod(value.c_str(), &end);
+            if (*end != '\0' || errno == ERANGE) throw kazm::Exception(filename, sets.size()+1, "Invalid parameter value " + value);
+            values.push_back(d);
+        }
+        if (values.size() > 0) sets.push_back(values);
+    }
+    return sets;
+}
+
+static std::vector<std::string> readBatch(const std::string& filename) {
+
+    std::ifstream file;
+    if (filename != "-") {
+        file.open(filename);
+        if (!file) throw kazm::Exception("Unable to open file list " + filename);
+    }
+    std::istream& in = filename == "-" ? std::cin : file;
+
+    std::vector<std::string> files;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::size_t first = line.find_first_not_of(" \t\r");
+        std::size_t last = line.find_last_not_of(" \t\r");
+        if (first != std::string::npos) files.push_back(line.substr(first, last - first + 1));
+    }
+    return files;
+}
+
+struct BatchResult {
+
+    std::string error;
+    std::size_t instructions;
+    double time;
+
+};
+
+static void runBatch(const std::vector<std::string>& files, std::size_t threads, bool cache) {
+
+    std::vector<BatchResult> results(files.size());
+
+    auto start = std::chrono::steady_clock::now();
+
+    kazm::ThreadPool pool(threads);
+    kazm::Trajectories queue(pool, 1);
+    queue.run(files.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            auto t = std::chrono::steady_clock::now();
+            try {
+                kazm::Parser parser;
+                if (!cache) parser.includes = nullptr;
+                parser.parse(files[i]);
+                results[i].instructions = parser.program.instructions.size();
+            }
+            catch (const std::exception& e) {
+                results[i].error = e.what();
+            }
+            results[i].time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+        }
+    });
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t failed = 0;
+    double total = 0;
+    for (std::size_t i = 0; i < files.size(); i++) {
+        if (results[i].error.empty()) std::cout << files[i] << " : " << results[i].instructions << " instructions in " << results[i].time << " s" << std::endl;
+        else {
+            std::cout << files[i] << " : " << results[i].error << std::endl;
+            failed++;
+        }
+        total += results[i].time;
+    }
+    std::cerr << "Batch: " << files.size() << " files, " << failed << " failed, " << pool.nthreads << " threads in " << wall << " s (parse time " << total << " s)" << std::endl;
+}
+
+static void printUnitary(kazm::Parser& parser, const std::string& name, const std::vector<std::vector<double> >& sets, kazm::KernelType kernel) {
+
+    kazm::Gate* gate = nullptr;
+    for (kazm::Gate* g : parser.gates) {
+        if (g && g->name == name) gate = g;
+    }
+    if (!gate) throw kazm::Exception(name + " is not a gate");
+
+    std::size_t dim = std::size_t(1) << gate->nqubits;
+    std::vector<std::complex<double> > matrix;
+    for (std::size_t s = 0; s < sets.size(); s++) {
+        gate->unitary(sets[s], kernel, matrix);
+        std::cout << name << "(";
+        for (std::size_t i = 0; i < sets[s].size(); i++) {
+            std::cout << gate->param_names[i] << "=" << sets[s][i];
+            if (i != sets[s].size()-1) std::cout << ", ";
+        }
+        std::cout << ")" << std::endl;
+        for (std::size_t r = 0; r < dim; r++) {
+            for (std::size_t c = 0; c < dim; c++) std::cout << matrix[r*dim+c] << (c != dim-1 ? " " : "\n");
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
 
     auto parser = std::make_shared<kazm::Parser>();
 
     try {
-        if (argc != 2) throw kazm::Exception("Expect one command line argument -- name of the source file");
-        parser->parse(argv[1]);
-        std::cout << parser->str();
+        std::string filename = "";
+        std::string sweep = "";
+        std::string emit = "";
+        std::string load = "";
+        std::string batch = "";
+        std::string unitary = "";
+        bool simulate = false;
+        bool sampling = true;
+        bool cache = true;
+        kazm::BackendType backend = kazm::backend_statevector;
+        std::size_t shots = 1024;
+        uint64_t seed = 0;
+        std::size_t threads = 1;
+        std::size_t fusion = 0;
+        std::size_t bond = 64;
+        kazm::KernelType kernel = kazm::Kernels::Detect();
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--simulate") simulate = true;
+            else if (arg == "--shots") shots = parseNumber(i, argc, argv);
+            else if (arg == "--seed") seed = parseNumber(i, argc, argv);
+            else if (arg == "--threads") threads = parseNumber(i, argc, argv);
+            else if (arg == "--fuse") fusion = parseNumber(i, argc, argv);
+            else if (arg == "--bond") bond = parseNumber(i, argc, argv);
+            else if (arg == "--no-sampling") sampling = false;
+            else if (arg == "--no-include-cache") cache = false;
+            else if (arg == "--include-cache") {
+                if (++i == argc) throw kazm::Exception("Expect a directory after --include-cache");
+                kazm::IncludeCache::Shared().directory = argv[i];
+            }
+            else if (arg == "--emit-ir") {
+                if (++i == argc) throw kazm::Exception("Expect an output file after --emit-ir");
+                emit = argv[i];
+            }
+            else if (arg == "--load-ir") {
+                if (++i == argc) throw kazm::Exception("Expect an IR file after --load-ir");
+                load = argv[i];
+            }
+            else if (arg == "--batch") {
+                if (++i == argc) throw kazm::Exception("Expect a file list after --batch");
+                batch = argv[i];
+            }
+            else if (arg == "--unitary") {
+                if (++i == argc) throw kazm::Exception("Expect a gate name after --unitary");
+                unitary = argv[i];
+            }
+            else if (arg == "--sweep") {
+                if (++i == argc) throw kazm::Exception("Expect a parameter file after --sweep");
+                sweep = argv[i];
+            }
+            else if (arg == "--backend") {
+                if (++i == argc) throw kazm::Exception("Expect a backend name after --backend");
+                backend = kazm::Simulator::GetBackend(argv[i]);
+            }
+            else if (arg == "--kernel") {
+                if (++i == argc) throw kazm::Exception("Expect a kernel name after --kernel");
+                kernel = kazm::Kernels::GetType(argv[i]);
+            }
+            else if (arg.size() > 1 && arg[0] == '-') throw kazm::Exception("Unknown option " + arg);
+            else if (filename != "") throw kazm::Exception("Expect one source file, found " + filename + " and " + arg);
+            else filename = arg;
+        }
+
+        if (fusion > kazm::Fusion::max_width) throw kazm::Exception("Fusion width must be at most " + std::to_string(kazm::Fusion::max_width) + " qubits");
+
+        if (batch != "") {
+            if (filename != "" || load != "" || emit != "" || simulate || sweep != "" || unitary != "") throw kazm::Exception("--batch only parses the listed files");
+            runBatch(readBatch(batch), threads == 0 ? std::thread::hardware_concurrency() : threads, cache);
+            return 0;
+        }
+
+        if (filename != "" && load != "") throw kazm::Exception("Expect either a source file or --load-ir, found both");
+        if (filename == "" && load == "") throw kazm::Exception("Expect one command line argument -- name of the source file");
+
+        if (unitary != "" && simulate) throw kazm::Exception("--unitary does not simulate, drop --simulate");
+
+        parser->symbolic = sweep != "" && unitary == "";
+        parser->threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+        if (!cache) parser->includes = nullptr;
+        if (load != "") kazm::IRReader(load).read(*parser);
+        else parser->parse(filename);
+
+        if (emit != "") kazm::IRWriter().write(*parser, emit);
+
+        if (unitary != "") {
+            printUnitary(*parser, unitary, sweep != "" ? readSweep(sweep) : std::vector<std::vector<double> >(1), kernel);
+        }
+        else if (sweep != "") {
+            auto sets = readSweep(sweep);
+            kazm::Simulator simulator(parser->program, parser->qubit_space, parser->clbit_space);
+            simulator.seed = seed;
+            simulator.kernel = kernel;
+            simulator.threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+            simulator.fusion = fusion;
+            simulator.sampling = sampling;
+            simulator.backend = backend;
+            simulator.bond = bond;
+            auto counts = simulator.sweep(sets, shots);
+            std::cerr << "Sweep: " << sets.size() << " parameter sets in " << simulator.run_time << " s" << std::endl;
+            for (std::size_t s = 0; s < sets.size(); s++) {
+                for (std::size_t i = 0; i < sets[s].size(); i++) {
+                    std::cout << parser->program.param_names[i] << "=" << sets[s][i];
+                    std::cout << (i != sets[s].size()-1 ? " " : "\n");
+                }
+                for (auto it = counts[s].begin(); it != counts[s].end(); ++it) std::cout << it->first << " : " << it->second << std::endl;
+            }
+        }
+        else if (!simulate) {
+            if (emit == "") std::cout << parser->str();
+        }
+        else {
+            kazm::Simulator simulator(parser->program, parser->qubit_space, parser->clbit_space);
+            simulator.seed = seed;
+            simulator.kernel = kernel;
+            simulator.threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+            simulator.fusion = fusion;
+            simulator.sampling = sampling;
+            simulator.backend = backend;
+            simulator.bond = bond;
+            auto counts = simulator.run(shots);
+            if (backend == kazm::backend_mps) {
+                std::cerr << "MPS (bond " << bond << "): maximum bond " << simulator.max_bond << ", truncation error " << simulator.truncation << " in " << simulator.run_time << " s" << std::endl;
+            }
+            if (fusion > 0) {
+                std::cerr << "Fusion (width " << fusion << "): " << simulator.passes_before << " passes -> " << simulator.passes_after << " passes in " << simulator.fusion_time << " s" << std::endl;
+                std::cerr << "Simulation: " << simulator.run_time << " s" << std::endl;
+            }
+            for (auto it = counts.begin(); it != counts.end(); ++it) std::cout << it->first << " : " << it->second << std::endl;
+        }
     }
     catch (const kazm::Exception& e) {
         std::cerr << e.what() << std::endl;
     }
+    catch (const std::exception& e) {
+        std::cerr << "[KAZM error]: " << e.what() << std::endl;
+    }
 
     return 0;
 }
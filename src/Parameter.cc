@@ -4,24 +4,35 @@ namespace kazm {
 
     Parameter::Parameter():
         name(""),
-        value(std::shared_ptr<Expression>())
+        index(0),
+        value(nullptr)
     {
     }
 
     Parameter::Parameter(const std::string& n):
         name(n),
-        value(std::shared_ptr<Expression>())
+        index(0),
+        value(nullptr)
     {
     }
 
-    Parameter::Parameter(const std::shared_ptr<Constant>& c):
+    Parameter::Parameter(const std::string& n, std::size_t i):
+        name(n),
+        index(i),
+        value(nullptr)
+    {
+    }
+
+    Parameter::Parameter(Constant* c):
         name(""),
+        index(0),
         value(c)
     {
     }
 
-    Parameter::Parameter(const std::string& n, const std::shared_ptr<Constant>& c):
-        name(n),  
+    Parameter::Parameter(const std::string& n, Constant* c):
+        name(n),
+        index(0),
         value(c)
     {
     }
@@ -36,4 +47,18 @@ namespace kazm {
         return value->str();
     }
 
+    Expression* Parameter::substitute(Arena& arena, const std::vector<Expression*>& args) {
+        if (value) return value->substitute(arena, args);
+        return args[index];
+    }
+
+    bool Parameter::isConstant() {
+        return value && value->isConstant();
+    }
+
+    void Parameter::compile(Bytecode& code) {
+        if (value) value->compile(code);
+        else code.parameter(index);
+    }
+
 }
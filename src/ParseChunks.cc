@@ -0,0 +1,154 @@
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+
+#include <Parser.h>
+#include <Instruction.h>
+#include <ThreadPool.h>
+#include <Trajectories.h>
+
+namespace kazm {
+
+    static const std::size_t chunk_bytes = 1 << 20;
+
+    static std::size_t Split(const char* data, std::size_t size, std::size_t pos) {
+
+        const void* nl = std::memchr(data + pos, '\n', size - pos);
+        if (!nl) return size;
+        pos = static_cast<const char*>(nl) - data + 1;
+
+        while (pos < size) {
+            if (data[pos] == ';') return pos + 1;
+            if (data[pos] == '/' && pos + 1 < size && data[pos+1] == '/') {
+                nl = std::memchr(data + pos, '\n', size - pos);
+                if (!nl) return size;
+                pos = static_cast<const char*>(nl) - data + 1;
+            }
+            else pos++;
+        }
+        return size;
+    }
+
+    static void Relocate(Instruction* inst, const Program& prog, std::size_t p, std::size_t b) {
+
+        inst->caller = &prog;
+        if (inst->type == instruction_if) Relocate(dynamic_cast<IfInst*>(inst)->inst, prog, p, b);
+        else if (inst->type == instruction_barrier) dynamic_cast<BarrierInst*>(inst)->first += b;
+        else if (inst->type == instruction_call) {
+            auto call = dynamic_cast<CallInst*>(inst);
+            call->params += p;
+            call->bits += b;
+        }
+    }
+
+    std::size_t Parser::parseChunks(std::size_t it) throw (Exception) {
+
+        SourceFile& file = *files.back();
+        std::size_t begin = tokens[it].text - file.data;
+
+        std::size_t count = (file.size - begin) / chunk_bytes;
+        if (count > 4 * threads) count = 4 * threads;
+        if (count < 2) return file.size;
+
+        std::vector<std::size_t> splits(1, begin);
+        for (std::size_t k = 1; k < count; k++) {
+            std::size_t target = begin + (file.size - begin) / count * k;
+            if (target < splits.back()) target = splits.back();
+            std::size_t pos = Split(file.data, file.size, target);
+            if (pos >= file.size) break;
+            if (pos > splits.back()) splits.push_back(pos);
+        }
+        splits.push_back(file.size);
+
+        std::size_t n = splits.size() - 1;
+        if (n < 2) return file.size;
+
+        std::vector<std::shared_ptr<Parser> > parts(n);
+        std::vector<char> parsed(n, 0);
+        std::atomic<std::size_t> failed(n);
+
+        ThreadPool pool(threads);
+        Trajectories queue(pool, 1);
+
+        queue.run(n, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                if (i > failed.load()) continue;
+                auto part = std::make_shared<Parser>();
+                part->includes = nullptr;
+                part->qasm_version = qasm_version;
+                part->symbols = symbols;
+                part->cregs = cregs;
+                part->qregs = qregs;
+                part->gates = gates;
+                part->program.registers = program.registers;
+                part->program.reg_offsets = program.reg_offsets;
+                part->program.reg_sizes = program.reg_sizes;
+                parsed[i] = part->parseChunk(file.filename, file.data + splits[i], splits[i+1] - splits[i]);
+                parts[i] = part;
+                if (parsed[i]) continue;
+                std::size_t f = failed.load();
+                while (i < f && !failed.compare_exchange_weak(f, i));
+            }
+        });
+
+        std::size_t good = 0;
+        while (good < n && parsed[good]) good++;
+
+        std::vector<std::size_t> pbase(good + 1, program.pstack.size());
+        std::vector<std::size_t> bbase(good + 1, program.operands.size());
+        std::vector<std::size_t> ibase(good + 1, program.instructions.size());
+        for (std::size_t i = 0; i < good; i++) {
+            pbase[i+1] = pbase[i] + parts[i]->program.pstack.size();
+            bbase[i+1] = bbase[i] + parts[i]->program.operands.size();
+            ibase[i+1] = ibase[i] + parts[i]->program.instructions.size();
+        }
+        program.pstack.resize(pbase[good]);
+        program.operands.resize(bbase[good]);
+        program.instructions.resize(ibase[good]);
+
+        queue.run(good, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                const Program& part = parts[i]->program;
+                std::copy(part.pstack.begin(), part.pstack.end(), program.pstack.begin() + pbase[i]);
+                std::copy(part.operands.begin(), part.operands.end(), program.operands.begin() + bbase[i]);
+                for (std::size_t k = 0; k < part.instructions.size(); k++) {
+                    Relocate(part.instructions[k], program, pbase[i], bbase[i]);
+                    program.instructions[ibase[i]+k] = part.instructions[k];
+                }
+            }
+        });
+
+        for (std::size_t i = 0; i < good; i++) chunks.push_back(parts[i]);
+
+        if (good == n) {
+            tokens[it] = Token(0, tokens[it].line);
+            return file.size;
+        }
+
+        file.seek(splits[good], tokens[it].line + std::count(file.data + begin, file.data + splits[good], '\n'));
+        tokens[it] = file.scan();
+        return splits[good+1];
+    }
+
+    bool Parser::parseChunk(const std::string& filename, const char* data, std::size_t size) {
+
+        files.push_back(std::make_shared<SourceFile>(filename, data, size, symbols));
+
+        try {
+            tokens.push_back(files.back()->scan());
+            while (tokens[0].type != 0) {
+                auto n = parseProgramStatement(0);
+                if (n == 0) return false;
+                tokens.release(0, n);
+            }
+        }
+        catch (const std::exception& e) {
+            return false;
+        }
+
+        tokens.pop_back();
+        files.pop_back();
+        return true;
+    }
+
+}
@@ -1,5 +1,6 @@
 #include <Parser.h>
 #include <Constant.h>
+#include <Parameter.h>
 
 namespace kazm {
 
@@ -8,12 +9,12 @@ namespace kazm {
         std::size_t n = 0;
         std::size_t m = 0;
 
-        std::shared_ptr<Expression> exp;
+        Expression* exp = nullptr;
         if ( (m = parseExp(it+n, prog, exp)) == 0 || !exp) return 0;
         n += m;
         ev.push_back(prog.pstack.size());
-        prog.pstack.push_back(std::move(exp));
-        exp.reset();
+        prog.pstack.push_back(exp);
+        exp = nullptr;
 
         while (true) {
 
@@ -22,14 +23,14 @@ namespace kazm {
             if ( (m = parseExp(it+n, prog, exp)) == 0 || !exp) throw Exception(files.back()->filename, tokens[it+n].line, "Expecting a parameter/expression after \',\'");
             n += m;
             ev.push_back(prog.pstack.size());
-            prog.pstack.push_back(std::move(exp));
-            exp.reset();
+            prog.pstack.push_back(exp);
+            exp = nullptr;
 
         }
 
     }
 
-    std::size_t Parser::parseExp(std::size_t it, Program& prog, std::shared_ptr<Expression>& exp) throw (Exception) {
+    std::size_t Parser::parseExp(std::size_t it, Program& prog, Expression*& exp) throw (Exception) {
 
         std::size_t n = 0;
         std::size_t m = 0;
@@ -45,28 +46,28 @@ namespace kazm {
                 parseToken('*', it+n) || parseToken('/', it+n) ||
                 parseToken('^', it+n))
             {
-                op = tokens[it+n].value;
+                op = tokens[it+n].str();
             }
 
             if (op == "") return n;
             n++;
 
-            std::shared_ptr<Expression> rhs;
+            Expression* rhs = nullptr;
             m = parseBinaryRHS(it+n, prog, op, rhs);
             if (m == 0 || !rhs) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after " + op);
-            exp = std::make_shared<BinaryExpression>(BinaryExpression::GetType(op), std::move(exp), std::move(rhs));
+            exp = Constant::Fold(arena, arena.make<BinaryExpression>(BinaryExpression::GetType(op), exp, rhs));
             n += m;
 
         }
 
     } 
 
-    std::size_t Parser::parseBinaryRHS(std::size_t it, Program& prog, const std::string& preop, std::shared_ptr<Expression>& rhs) throw (Exception) {
+    std::size_t Parser::parseBinaryRHS(std::size_t it, Program& prog, const std::string& preop, Expression*& rhs) throw (Exception) {
 
         std::size_t n = 0;
         std::size_t m = 0;
 
-        std::shared_ptr<Expression> r1;
+        Expression* r1 = nullptr;
         m = parseUnary(it+n, prog, r1);
         if (m == 0 || !r1) return 0;
         n += m;
@@ -78,86 +79,88 @@ namespace kazm {
                 parseToken('*', it+n) || parseToken('/', it+n) ||
                 parseToken('^', it+n))
             {
-                op = tokens[it+n].value;
+                op = tokens[it+n].str();
             }
 
-            if (op == "" || BinaryExpression::GetPrecedence(op) < BinaryExpression::GetPrecedence(preop)) {
+            if (op == "" || BinaryExpression::GetPrecedence(op) < BinaryExpression::GetPrecedence(preop) ||
+                (BinaryExpression::GetPrecedence(op) == BinaryExpression::GetPrecedence(preop) && op != "^"))
+            {
                 rhs = r1;
-                if (op != "") return n+1;
-                else return n;
+                return n;
             }
             n++;
 
-            std::shared_ptr<Expression> r2;
+            Expression* r2 = nullptr;
             m = parseBinaryRHS(it+n, prog, op, r2);
             if (m == 0 || !r2) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after " + op);
-            r1 = std::make_shared<BinaryExpression>(BinaryExpression::GetType(op), std::move(r1), std::move(r2));
+            r1 = Constant::Fold(arena, arena.make<BinaryExpression>(BinaryExpression::GetType(op), r1, r2));
             n += m;            
 
         }
 
     }
 
-    std::size_t Parser::parseUnary(std::size_t it, Program& prog, std::shared_ptr<Expression>& exp) throw (Exception) {
+    std::size_t Parser::parseUnary(std::size_t it, Program& prog, Expression*& exp) throw (Exception) {
 
         std::size_t n = 0;
         std::size_t m = 0;
 
-        std::map<std::string, std::size_t> pmap;
-
         if (parseToken(T_PI, it) || parseToken(T_REAL, it) || parseToken(T_NNINTEGER, it)) {
-            exp = std::make_shared<Constant>(tokens[it].value);
+            exp = arena.make<Constant>(tokens[it].str());
             return 1;
         }
 
         else if (parseToken(T_ID, it)) {
-            std::string pname = tokens[it].value;
-            try {
-                auto gate = dynamic_cast<Gate&>(prog);
-                pmap = gate.param_map;
-            }
-            catch (const std::bad_cast& e) {
+            std::size_t id = tokens[it].id;
+            std::size_t index = prog.param(id);
+            if (index == SymbolTable::npos) {
+                const std::string& pname = symbols.name(id);
+                if (!symbolic || &prog != &program) throw Exception(files.back()->filename, tokens[it+n].line, "Unknown parameter " + pname);
+                index = prog.params.size();
+                prog.mapParam(id, index);
+                prog.param_names.push_back(pname);
+                prog.params.push_back(arena.make<Parameter>(pname, index));
             }
-            if (pmap.find(pname) == pmap.end()) throw Exception(files.back()->filename, tokens[it+n].line, "Unknown parameter " + pname);
-            exp = prog.pstack[pmap[pname]];
+            exp = prog.params[index];
             return 1;         
         }
 
         else if (parseToken('+', it) || parseToken('-', it)) {
             n++;
-            std::shared_ptr<Expression> e;
+            Expression* e = nullptr;
             m = parseUnary(it+n, prog, e);
-            if (m == 0 || !e) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after " + tokens[it].value);
-            exp = std::move(e);
+            if (m == 0 || !e) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after " + tokens[it].str());
+            if (tokens[it].type == '-') exp = Constant::Fold(arena, arena.make<UnaryExpression>(unaryop_negate, e));
+            else exp = std::move(e);
             return n+m;
         }
 
         else if (parseToken('(', it)) {
             n++;
-            std::shared_ptr<Expression> e;
+            Expression* e = nullptr;
             m = parseExp(it+n, prog, e);
             if (m == 0 || !e) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after \'(\'");
             n += m;
             if (!parseToken(')', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Missing \')\'");
             n++;
-            exp = std::move(e);
+            exp = Constant::Fold(arena, arena.make<UnaryExpression>(unaryop_nop, e));
             return n;
         }
 
         else if (parseToken(T_SIN, it) || parseToken(T_COS, it) || parseToken(T_TAN, it) || 
                  parseToken(T_EXP, it) || parseToken(T_LN , it) || parseToken(T_SQRT, it))
         {
-            std::string unary_str = tokens[it].value;
+            std::string unary_str = tokens[it].str();
             n++;
             if (!parseToken('(', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \'(\' after " + unary_str);
             n++;
-            std::shared_ptr<Expression> e;
+            Expression* e = nullptr;
             m = parseExp(it+n, prog, e);
             if (m == 0 || !e) throw Exception(files.back()->filename, tokens[it+n].line, "Unable to parse expression after \'(\'");
             n += m;
             if (!parseToken(')', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Missing \')\'");
             n++;
-            exp = std::make_shared<UnaryExpression>(UnaryExpression::GetType(unary_str), e);
+            exp = Constant::Fold(arena, arena.make<UnaryExpression>(UnaryExpression::GetType(unary_str), e));
             return n;
         }
 
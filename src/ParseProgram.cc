@@ -2,7 +2,6 @@
 
 #include <Parser.h>
 #include <Instruction.h>
-#include <Bit.h>
 
 namespace kazm {
 
@@ -10,86 +9,88 @@ namespace kazm {
 
         std::size_t n = 0;
 
-        std::shared_ptr<Instruction> inst;
+        Instruction* inst = nullptr;
 
-        std::pair<std::size_t, std::string> condition;
+        std::pair<Operand, std::string> condition;
         bool isConditioned = false;
         if (parseToken(T_IF, it+n)) {
             n++;
             if (!parseToken('(', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \'(\' after \'if\'");
             n++;
             if (!parseToken(T_ID, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect identifier' after \'if (\'");
-            auto cr = tokens[it+n].value;
-            if (!isCReg(cr)) throw Exception(files.back()->filename, tokens[it+n].line, cr + " is not defined as a classical register");
+            std::size_t cr_id = tokens[it+n].id;
+            const std::string& cr = symbols.name(cr_id);
+            if (!isCReg(cr_id)) throw Exception(files.back()->filename, tokens[it+n].line, cr + " is not defined as a classical register");
             n++;
             if (!parseToken(T_EQUALS, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect == after \'if (" + cr + "\'");
             n++;
             if (!parseToken(T_NNINTEGER, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect integer after \'if (" + cr + " == \'");
-            std::string num = tokens[it+n].value;
+            std::string num = tokens[it+n].str();
             n++;
             if (!parseToken(')', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \')\' at the end of \'if\' condition");
             n++;
-            program.bstack.push_back(cregs[cr]);
-            condition.first = program.bstack.size() - 1;
+            condition.first = Operand(cregs[cr_id]->index(), 0, true);
             condition.second = num;
             isConditioned = true;
         }
 
         if (parseToken(T_MEASURE, it+n)) {
             n++;
-            std::shared_ptr<Data> qubit;
-            std::shared_ptr<Data> clbit;
+            Operand qubit;
+            Operand clbit;
             std::size_t m = parseQubitReg(it+n, qubit);
-            if (m == 0 || !qubit || !qubit->isQuantum()) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit/register after \'measure\'");
+            if (m == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit/register after \'measure\'");
             n += m;
             if (!parseToken(T_YIELDS, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \'->\' after qubit(s) to measure");
             n++;
             m = parseBitReg(it+n, clbit);
-            if (m == 0 || !clbit || !clbit->isClassical()) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a bit/register after \'->\'");
+            if (m == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a bit/register after \'->\'");
             n += m;
+            std::string error = program.checkMeasure(qubit, clbit);
+            if (!error.empty()) throw Exception(files.back()->filename, tokens[it].line, error);
             if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of measure statement");
             n++;
 
-            std::size_t nb = program.bstack.size();
-            program.bstack.push_back(qubit);
-            program.bstack.push_back(clbit);
-            inst = std::make_shared<MeasureInst>(program, nb, nb+1);
+            inst = arena.make<MeasureInst>(program, qubit, clbit);
         }
 
         else if (parseToken(T_RESET, it+n)) {
             n++;
-            std::shared_ptr<Data> qubit;
+            Operand qubit;
             std::size_t m = parseQubitReg(it+n, qubit);
-            if (m == 0 || !qubit || !qubit->isQuantum()) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit/register after \'reset\'");
+            if (m == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit/register after \'reset\'");
             n += m;
             if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of measure statement");
             n++;
 
-            inst = std::make_shared<ResetInst>(program, program.bstack.size());
-            program.bstack.push_back(qubit);
+            inst = arena.make<ResetInst>(program, qubit);
         }
 
         else if (parseToken(T_BARRIER, it+n)) {
             n++;
-            std::vector<std::size_t> qidxv;
-            std::size_t m = parseQubitRegList(it+n, qidxv);
-            if (m == 0 || qidxv.size() == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect one or more qubit/registers after \'barrier\'");
+            std::size_t first = program.operands.size();
+            std::size_t count = 0;
+            std::size_t m = parseQubitRegList(it+n, count);
+            if (m == 0 || count == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect one or more qubit/registers after \'barrier\'");
             n += m;
             if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of barrier statement");
             n++;
-            inst = std::make_shared<BarrierInst>(program, qidxv);
+            inst = arena.make<BarrierInst>(program, first, count);
         }
 
         else if (parseToken(T_ID, it+n) || parseToken(T_U, it+n) || parseToken(T_CX, it+n)) {
-            std::string gname = tokens[it+n].value;
-            std::string gate_name = gname;
-            if (parseToken(T_U, it+n)) gate_name = "__u__";
-            if (parseToken(T_CX, it+n)) gate_name = "__cnot__";
-            n++;
-            if (!isGate(gate_name)) throw Exception(files.back()->filename, tokens[it+n].line, gname + " is not a gate");
-            auto gate = gates[gate_name];
+            std::string gname = tokens[it+n].str();
+            std::size_t gate_id = tokens[it+n].id;
+            if (parseToken(T_U, it+n)) gate_id = symbols.find("__u__");
+            if (parseToken(T_CX, it+n)) gate_id = symbols.find("__cnot__");
+            n++;
+            if (!isGate(gate_id)) throw Exception(files.back()->filename, tokens[it+n].line, gname + " is not a gate");
+            auto gate = gates[gate_id];
+            const std::string& gate_name = gate->name;
             std::vector<std::size_t> expv;
-            std::vector<std::size_t> qidxv;
+            std::size_t pfirst = program.pstack.size();
+            std::size_t bfirst = program.operands.size();
+            std::size_t count = 0;
             if (gate->nparams == 0) {
                 if (gate_name == "CX") {
                     if (parseToken('(', it+n)) {
@@ -117,137 +118,110 @@ namespace kazm {
                 if (!parseToken(')', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \')\' after parameter list for gate " + gname);
                 n++;
             }
-            std::size_t m = parseQubitRegList(it+n, qidxv);
-            if (qidxv.size() != gate->nqubits) {
+            std::size_t m = parseQubitRegList(it+n, count);
+            if (count != gate->nqubits) {
                 std::stringstream ss;
-                ss << gate->name << " gate expects " << gate->nqubits << " qubits/registers, " << qidxv.size() << " provided";
+                ss << gate->name << " gate expects " << gate->nqubits << " qubits/registers, " << count << " provided";
                 throw Exception(files.back()->filename, tokens[it+n].line, ss.str());
             }
             n += m;
             if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of call to gate " + gname);
             n++;
-            inst = std::make_shared<CallInst>(program, gate, expv, qidxv);
+            inst = arena.make<CallInst>(program, gate, pfirst, bfirst);
         }
 
         if ( isConditioned && !inst) throw Exception(files.back()->filename, tokens[it+n].line, "if statement not followed by a valid instruction");
         if (!isConditioned && !inst) return 0;
         if (!isConditioned &&  inst) program.instructions.push_back(inst);
-        if ( isConditioned &&  inst) program.instructions.push_back(std::make_shared<IfInst>(program, condition.first, condition.second, inst));
+        if ( isConditioned &&  inst) program.instructions.push_back(arena.make<IfInst>(program, condition.first, condition.second, inst));
 
         return n;
 
     }
 
-    std::size_t Parser::parseQubitReg(std::size_t it, std::shared_ptr<Data>& data) throw (Exception) {
+    std::size_t Parser::parseQubitReg(std::size_t it, Operand& op) throw (Exception) {
 
         std::size_t n = 0;
 
         if (!parseToken(T_ID, it)) return 0;
-        const std::string& reg = tokens[it].value;
-        if (!isQReg(reg)) return 0;
+        std::size_t reg_id = tokens[it].id;
+        if (!isQReg(reg_id)) return 0;
+        const std::string& reg = symbols.name(reg_id);
         n++;
 
         if (parseToken('[', it+n)) {
             n++;
             if (!parseToken(T_NNINTEGER, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect an index after \'[\'");
-            uint64_t idx = strtoull(tokens[it+n].value.c_str(), nullptr, 0);
+            uint64_t idx = strtoull(tokens[it+n].str().c_str(), nullptr, 0);
             if (errno == ERANGE) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of range");
-            if (idx >= qregs[reg]->size()) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of bounds");
+            if (idx >= qregs[reg_id]->size()) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of bounds");
             n++;
             if (!parseToken(']', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \']\' after register index");
             n++;
-            data = std::make_shared<Bit>(qregs[reg], idx);
+            op = Operand(qregs[reg_id]->index(), idx, false);
             return n;
         }
 
-        data = qregs[reg];
+        op = Operand(qregs[reg_id]->index(), 0, true);
         return n;
 
     }
 
-    std::size_t Parser::parseBitReg(std::size_t it, std::shared_ptr<Data>& data) throw (Exception) {
+    std::size_t Parser::parseBitReg(std::size_t it, Operand& op) throw (Exception) {
 
         std::size_t n = 0;
 
         if (!parseToken(T_ID, it)) return 0;
-        const std::string& reg = tokens[it].value;
-        if (!isCReg(reg)) return 0;
+        std::size_t reg_id = tokens[it].id;
+        if (!isCReg(reg_id)) return 0;
+        const std::string& reg = symbols.name(reg_id);
         n++;
 
         if (parseToken('[', it+n)) {
             n++;
             if (!parseToken(T_NNINTEGER, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect an index after \'[\'");
-            uint64_t idx = strtoull(tokens[it+n].value.c_str(), nullptr, 0);
+            uint64_t idx = strtoull(tokens[it+n].str().c_str(), nullptr, 0);
             if (errno == ERANGE) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of range");
-            if (idx >= cregs[reg]->size()) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of bounds");
+            if (idx >= cregs[reg_id]->size()) throw Exception(files.back()->filename, tokens[it].line, "Index of register " + reg + " is out of bounds");
             n++;
             if (!parseToken(']', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \']\' after register index");
             n++;
-            data = std::make_shared<Bit>(cregs[reg], idx);
+            op = Operand(cregs[reg_id]->index(), idx, false);
             return n;
         }
 
-        data = cregs[reg];
+        op = Operand(cregs[reg_id]->index(), 0, true);
         return n;
 
     }
 
-    std::size_t Parser::parseQubitRegList(std::size_t it, std::vector<std::size_t>& qidxv) throw (Exception) {
+    std::size_t Parser::parseQubitRegList(std::size_t it, std::size_t& count) throw (Exception) {
 
         std::size_t n = 0;
 
-        std::shared_ptr<Data> data;
-        std::size_t m = parseQubitReg(it+n, data);
+        Operand op;
+        std::size_t m = parseQubitReg(it+n, op);
         if (m == 0) return 0;
-        qidxv.push_back(program.bstack.size());
-        program.bstack.push_back(data);
+        std::size_t first = program.operands.size();
+        program.operands.push_back(op);
         n += m;
 
         while (true) {
 
             if (!parseToken(',', it+n)) break; 
             n++;
-            std::shared_ptr<Data> data;
-            m = parseQubitReg(it+n, data);
+            Operand op;
+            m = parseQubitReg(it+n, op);
             if (m == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit/register after \',\'");
-            qidxv.push_back(program.bstack.size());
-            program.bstack.push_back(data);
+            program.operands.push_back(op);
             n += m;
 
         }
 
-        std::vector<std::shared_ptr<Data> > regs;
-        std::vector<std::shared_ptr<Data> > bits;
-
-        for (std::size_t i = 0; i < qidxv.size(); i++) {
-            auto data = program.bstack[qidxv[i]];
-            if (data->isReg()) regs.push_back(data);
-            else bits.push_back(data);
-        }
+        count = program.operands.size() - first;
 
-        std::size_t reg_size = 0;
-        if (regs.size() > 0) reg_size = regs[0]->size();
-        for (std::size_t i = 1; i < regs.size(); i++) {
-            if (regs[i]->size() != reg_size) throw Exception(files.back()->filename, tokens[it].line, "Register arguments must have the same size");
-        }
-
-        for (std::size_t i = 0; i < regs.size(); i++) {
-            for (std::size_t j = i+1; j < regs.size(); j++) {
-                if (regs[i]->offset() == regs[j]->offset()) throw Exception(files.back()->filename, tokens[it].line, "Registers used in arguments must be unique");
-            }
-        }
-
-        for (std::size_t i = 0; i < bits.size(); i++) {
-            for (std::size_t j = i+1; j < bits.size(); j++) {
-                if (bits[i]->offset() == bits[j]->offset()) throw Exception(files.back()->filename, tokens[it].line, "Qubit arguments must be unique");
-            }
-        }
-
-        for (std::size_t i = 0; i < bits.size(); i++) {
-            for (std::size_t j = 0; j < regs.size(); j++) {
-                if (bits[i]->name() == regs[j]->name()) throw Exception(files.back()->filename, tokens[it].line, "Register " + regs[j]->name() + " overlaps with a qubit argument");
-            }
-        }
+        std::string error = program.checkOperands(first, count);
+        if (!error.empty()) throw Exception(files.back()->filename, tokens[it].line, error);
 
         return n;
 
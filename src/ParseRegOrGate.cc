@@ -15,23 +15,28 @@ namespace kazm {
 
         if (!parseToken(T_ID, it+1) || !parseToken('[', it+2) || !parseToken(T_NNINTEGER, it+3) || !parseToken(']', it+4) || !parseToken(';', it+5)) return 0;
 
-        const std::string& name = tokens[it+1].value;
-        if (isCReg(name)) throw Exception(files.back()->filename, tokens[it+1].line, tokens[it+1].value + " has been previously defined as a classical register");
-        if (isQReg(name)) throw Exception(files.back()->filename, tokens[it+1].line, tokens[it+1].value + " has been previously defined as a quantum register");
-        if (isGate(name)) throw Exception(files.back()->filename, tokens[it+1].line, tokens[it+1].value + " has been previously defined as a gate");
-
-        uint64_t sz = strtoull(tokens[it+3].value.c_str(), nullptr, 0);
-        if (errno == ERANGE) throw Exception(files.back()->filename, tokens[it+3].line, "Register size out of range");
+        std::size_t id = tokens[it+1].id;
+        const std::string& name = symbols.name(id);
+        define(id);
+        if (isCReg(id)) throw Exception(files.back()->filename, tokens[it+1].line, name + " has been previously defined as a classical register");
+        if (isQReg(id)) throw Exception(files.back()->filename, tokens[it+1].line, name + " has been previously defined as a quantum register");
+        if (isGate(id)) throw Exception(files.back()->filename, tokens[it+1].line, name + " has been previously defined as a gate");
+
+        uint64_t sz = strtoull(tokens[it+3].str().c_str(), nullptr, 0);
+        if (errno == ERANGE || sz > Operand::max_index) throw Exception(files.back()->filename, tokens[it+3].line, "Register size out of range");
         if (sz == 0) throw Exception(files.back()->filename, tokens[it+3].line, "Register size cannot be 0");
+        if (program.registers.size() > Operand::max_reg) throw Exception(files.back()->filename, tokens[it+1].line, "Number of registers exceeds limit");
 
         if (rt == data_classical) {
             if (clbit_space + sz < clbit_space) throw Exception(files.back()->filename, tokens[it+3].line, "Total size of bit space exceeds limit");
-            cregs[name] = std::make_shared<Register>(data_classical, name, sz, clbit_space);
+            cregs[id] = arena.make<Register>(data_classical, name, sz, clbit_space, program.registers.size());
+            program.addRegister(cregs[id]);
             clbit_space += sz;
         }
         else {
             if (qubit_space + sz < qubit_space) throw Exception(files.back()->filename, tokens[it+3].line, "Total size of qubit space exceeds limit");
-            qregs[name] = std::make_shared<Register>(data_quantum, name, sz, qubit_space);
+            qregs[id] = arena.make<Register>(data_quantum, name, sz, qubit_space, program.registers.size());
+            program.addRegister(qregs[id]);
             qubit_space += sz;
         }
 
@@ -49,22 +54,26 @@ namespace kazm {
         if (parseToken(T_OPAQUE, it)) opaque = true;
         n++;
         if (!parseToken(T_ID, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect identifier after opaque keyword");
-        auto gate_name = tokens[it+n].value;
-        if (isGate(gate_name)) throw Exception(files.back()->filename, tokens[it+n].line, "Gate " + gate_name + " is already declared");
+        std::size_t gate_id = tokens[it+n].id;
+        const std::string& gate_name = symbols.name(gate_id);
+        define(gate_id);
+        if (isGate(gate_id)) throw Exception(files.back()->filename, tokens[it+n].line, "Gate " + gate_name + " is already declared");
         n++;
 
         std::vector<std::string> param_list;
+        std::vector<std::size_t> param_ids;
         if (parseToken('(', it+n)) {
             n++;
 
             while (true) {
                 if (parseToken(T_ID, it+n)) {
-                    std::string id = tokens[it+n].value;
-                    for (std::size_t i = 0; i < param_list.size(); i++) {
-                        if (id == param_list[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Parameter names must be unique");
+                    std::size_t id = tokens[it+n].id;
+                    for (std::size_t i = 0; i < param_ids.size(); i++) {
+                        if (id == param_ids[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Parameter names must be unique");
                     }
                     n++;
-                    param_list.push_back(id);
+                    param_ids.push_back(id);
+                    param_list.push_back(symbols.name(id));
                     if (parseToken(',', it+n)) {
                         n++;
                         continue;
@@ -78,17 +87,19 @@ namespace kazm {
         }
 
         std::vector<std::string> qubit_list;
+        std::vector<std::size_t> qubit_ids;
         while (true) {
             if (parseToken(T_ID, it+n)) {
-                std::string id = tokens[it+n].value;
-                for (std::size_t i = 0; i < param_list.size(); i++) {
-                    if (id == param_list[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit names must be different than parameter names");
+                std::size_t id = tokens[it+n].id;
+                for (std::size_t i = 0; i < param_ids.size(); i++) {
+                    if (id == param_ids[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit names must be different than parameter names");
                 }
-                for (std::size_t i = 0; i < qubit_list.size(); i++) {
-                    if (id == qubit_list[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit names must be unique");
+                for (std::size_t i = 0; i < qubit_ids.size(); i++) {
+                    if (id == qubit_ids[i]) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit names must be unique");
                 }
                 n++;
-                qubit_list.push_back(id);
+                qubit_ids.push_back(id);
+                qubit_list.push_back(symbols.name(id));
                 if (parseToken(',', it+n)) {
                     n++;
                     continue;
@@ -98,12 +109,16 @@ namespace kazm {
         }
         if (qubit_list.size() == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect at least one qubit argument"); 
 
-        auto gate = std::make_shared<Gate>(gate_name, param_list, qubit_list);
+        auto gate = arena.make<Gate>(arena, gate_name, param_list, qubit_list);
+        for (std::size_t i = 0; i < param_ids.size(); i++) gate->mapParam(param_ids[i], i);
+        for (std::size_t i = 0; i < qubit_ids.size(); i++) gate->mapQubit(qubit_ids[i], i);
 
         if (opaque) {
             if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of opaque declaration");
             n++;
-            gates[gate_name] = std::make_shared<Gate>(gate_name, param_list, qubit_list);
+            gate->opaque = gate;
+            gate->compile();
+            gates[gate_id] = gate;
             return n;
         }
 
@@ -114,25 +129,28 @@ namespace kazm {
 
             if (parseToken(T_BARRIER, it+n)) {
                 n++;
-                std::vector<std::size_t> qidxv;
-                std::size_t m = parseQubitList(it+n, *gate, qidxv);
-                if (m == 0 || qidxv.size() == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect one or more qubits after \'barrier\'");
+                std::size_t first = gate->operands.size();
+                std::size_t count = 0;
+                std::size_t m = parseQubitList(it+n, *gate, count);
+                if (m == 0 || count == 0) throw Exception(files.back()->filename, tokens[it+n].line, "Expect one or more qubits after \'barrier\'");
                 n += m;
                 if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of barrier statement");
                 n++;
-                gate->instructions.push_back(std::make_shared<BarrierInst>(*gate, qidxv));
+                gate->instructions.push_back(arena.make<BarrierInst>(*gate, first, count));
             }
 
             else if (parseToken(T_ID, it+n) || parseToken(T_U, it+n) || parseToken(T_CX, it+n)) {
-                std::string gname = tokens[it+n].value;
-                std::string gt_name = gname;
-                if (parseToken(T_U, it+n)) gt_name = "__u__";
-                if (parseToken(T_CX, it+n)) gt_name = "__cnot__";
+                std::string gname = tokens[it+n].str();
+                std::size_t gt_id = tokens[it+n].id;
+                if (parseToken(T_U, it+n)) gt_id = symbols.find("__u__");
+                if (parseToken(T_CX, it+n)) gt_id = symbols.find("__cnot__");
                 n++;
-                if (!isGate(gt_name)) throw Exception(files.back()->filename, tokens[it+n].line, gname + " is not a gate");
-                auto gt = gates[gt_name];
+                if (!isGate(gt_id)) throw Exception(files.back()->filename, tokens[it+n].line, gname + " is not a gate");
+                auto gt = gates[gt_id];
                 std::vector<std::size_t> expv;
-                std::vector<std::size_t> qidxv;
+                std::size_t pfirst = gate->pstack.size();
+                std::size_t bfirst = gate->operands.size();
+                std::size_t count = 0;
                 if (gt->nparams == 0) {
                     if (gate_name == "CX") {
                         if (parseToken('(', it+n)) {
@@ -160,16 +178,16 @@ namespace kazm {
                     if (!parseToken(')', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \')\' after parameter list for gate " + gname);
                     n++;
                 }
-                std::size_t m = parseQubitList(it+n, *gate, qidxv);
-                if (qidxv.size() != gt->nqubits) {
+                std::size_t m = parseQubitList(it+n, *gate, count);
+                if (count != gt->nqubits) {
                     std::stringstream ss;
-                    ss << gt->name << " gate expects " << gt->nqubits << " qubits, " << qidxv.size() << " provided";
+                    ss << gt->name << " gate expects " << gt->nqubits << " qubits, " << count << " provided";
                     throw Exception(files.back()->filename, tokens[it+n].line, ss.str());
                 }
                 n += m;
                 if (!parseToken(';', it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect \';\' at the end of call to gate " + gname);
                 n++;
-                gate->instructions.push_back(std::make_shared<CallInst>(*gate, gt, expv, qidxv));
+                gate->instructions.push_back(arena.make<CallInst>(*gate, gt, pfirst, bfirst));
             }
 
             else break;
@@ -180,28 +198,28 @@ namespace kazm {
 
         if (gate->instructions.size() == 0) {
             for (std::size_t i = 0; i < gate->nqubits; i++) {
-                std::vector<std::size_t> expv;
-                std::vector<std::size_t> qidxv;
-                qidxv.push_back(i);
-                gate->instructions.push_back(std::make_shared<CallInst>(*gate, gates["__identity__"], expv, qidxv));
+                gate->instructions.push_back(arena.make<CallInst>(*gate, gates[symbols.find("__identity__")], gate->pstack.size(), gate->operands.size()));
+                gate->operands.push_back(Operand(i, 0, false));
             }
         }
 
-        gates[gate_name] = gate;
+        gate->compile();
+        gates[gate_id] = gate;
 
         return n;
 
     }
 
-    std::size_t Parser::parseQubitList(std::size_t it, const Gate& gate, std::vector<std::size_t>& qidxv) throw (Exception) {
+    std::size_t Parser::parseQubitList(std::size_t it, Gate& gate, std::size_t& count) throw (Exception) {
 
         std::size_t n = 0;
-        auto qmap = gate.qubit_map;
 
         if (!parseToken(T_ID, it)) return 0;
-        auto qid = tokens[it].value;
-        if (qmap.find(qid) == qmap.end()) return 0; 
-        qidxv.push_back(qmap[qid]);
+        std::size_t q = gate.qubit(tokens[it].id);
+        if (q == SymbolTable::npos) return 0; 
+        std::size_t first = gate.operands.size();
+        gate.operands.push_back(Operand(q, 0, false));
+        count = 1;
         n++;
 
         while (true) {
@@ -209,12 +227,13 @@ namespace kazm {
             if (!parseToken(',', it+n)) return n;
             n++;
             if (!parseToken(T_ID, it+n)) throw Exception(files.back()->filename, tokens[it+n].line, "Expect a qubit after \',\'");
-            qid = tokens[it+n].value;
-            if (qmap.find(qid) == qmap.end()) throw Exception(files.back()->filename, tokens[it+n].line, "Unknown qubit argument");
-            for (std::size_t i = 0; i < qidxv.size(); i++) {
-                if (qidxv[i] == qmap[qid]) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit argument " + qid + " is repeated");
+            q = gate.qubit(tokens[it+n].id);
+            if (q == SymbolTable::npos) throw Exception(files.back()->filename, tokens[it+n].line, "Unknown qubit argument");
+            for (std::size_t i = first; i < gate.operands.size(); i++) {
+                if (gate.operands[i].reg() == q) throw Exception(files.back()->filename, tokens[it+n].line, "Qubit argument " + symbols.name(tokens[it+n].id) + " is repeated");
             }
-            qidxv.push_back(qmap[qid]);
+            gate.operands.push_back(Operand(q, 0, false));
+            count++;
             n++;
 
         }
@@ -4,7 +4,10 @@ namespace kazm {
 
     Parser::Parser():
         clbit_space(0),
-        qubit_space(0)
+        qubit_space(0),
+        symbolic(false),
+        includes(&IncludeCache::Shared()),
+        threads(1)
     {
         std::vector<std::string> p_id = {};
         std::vector<std::string> p_cx = {};
@@ -12,35 +15,55 @@ namespace kazm {
         std::vector<std::string> b_id = {"q0"};
         std::vector<std::string> b_cx = {"q0", "q1"};
         std::vector<std::string> b_u  = {"q0"};
-        gates["__identity__"] = std::make_shared<Gate>("__identity__", p_id, b_id);
-        gates["__cnot__"] = std::make_shared<Gate>("__cnot__", p_cx, b_cx);
-        gates["__u__"] = std::make_shared<Gate>("__u__", p_u, b_u);
+        std::size_t id_id = symbols.intern("__identity__");
+        std::size_t id_cx = symbols.intern("__cnot__");
+        std::size_t id_u  = symbols.intern("__u__");
+        define(id_u);
+        gates[id_id] = arena.make<Gate>(arena, "__identity__", p_id, b_id);
+        gates[id_cx] = arena.make<CXGate>(arena, "__cnot__", p_cx, b_cx);
+        gates[id_u]  = arena.make<UGate>(arena, "__u__", p_u, b_u);
+        for (std::size_t i = 0; i < gates.size(); i++) gates[i]->compile();
     }
 
-    bool Parser::isCReg(const std::string& name) {
-        return cregs.find(name) != cregs.end();
+    bool Parser::isCReg(std::size_t id) {
+        return id < cregs.size() && cregs[id];
     }
 
-    bool Parser::isQReg(const std::string& name) { 
-        return qregs.find(name) != qregs.end();
+    bool Parser::isQReg(std::size_t id) { 
+        return id < qregs.size() && qregs[id];
     }
 
-    bool Parser::isGate(const std::string& name) {
-        return gates.find(name) != gates.end();
+    bool Parser::isGate(std::size_t id) {
+        return id < gates.size() && gates[id];
+    }
+
+    void Parser::define(std::size_t id) {
+        if (id < gates.size()) return;
+        cregs.resize(id + 1);
+        qregs.resize(id + 1);
+        gates.resize(id + 1);
     }
 
     std::string Parser::str() {
+        std::map<std::string, Register*> cr;
+        std::map<std::string, Register*> qr;
+        std::map<std::string, Gate*> gt;
+        for (std::size_t i = 0; i < gates.size(); i++) {
+            if (cregs[i]) cr[symbols.name(i)] = cregs[i];
+            if (qregs[i]) qr[symbols.name(i)] = qregs[i];
+            if (gates[i]) gt[symbols.name(i)] = gates[i];
+        }
         std::string s = "";
-        for (auto it = cregs.begin(); it != cregs.end(); ++it) s += it->second->str();
-        for (auto it = qregs.begin(); it != qregs.end(); ++it) s += it->second->str();
-        for (auto it = gates.begin(); it != gates.end(); ++it) s += it->second->str();
+        for (auto it = cr.begin(); it != cr.end(); ++it) s += it->second->str();
+        for (auto it = qr.begin(); it != qr.end(); ++it) s += it->second->str();
+        for (auto it = gt.begin(); it != gt.end(); ++it) s += it->second->str();
         s += program.str();
         return s;
     }
 
     void Parser::parse(const std::string& filename) throw (Exception) {
     
-        files.push_back(std::make_shared<SourceFile>(filename));
+        files.push_back(std::make_shared<SourceFile>(filename, symbols));
         
         std::size_t s = tokens.size();
         
@@ -50,12 +73,21 @@ namespace kazm {
             if (tokens[s].type == 0) return;
             auto n = parseHeader(s);
             if (n == 0) throw Exception(filename, tokens[s].line, "Missing header");
-            tokens.erase(tokens.begin()+s, tokens.begin()+s+n);
+            tokens.release(s, n);
         }
 
+        std::size_t resume = 0;
+
         while (tokens[s].type != 0) {
+            if (threads > 1 && !symbolic && files.size() == 1 && std::size_t(tokens[s].text - files.back()->data) >= resume) {
+                int t = tokens[s].type;
+                if (t == T_IF || t == T_MEASURE || t == T_RESET || t == T_BARRIER || t == T_ID || t == T_U || t == T_CX) {
+                    resume = parseChunks(s);
+                    continue;
+                }
+            }
             auto n = parseUnit(s);
-            tokens.erase(tokens.begin()+s, tokens.begin()+s+n);
+            tokens.release(s, n);
         }
         
         tokens.pop_back();
@@ -76,9 +108,9 @@ namespace kazm {
         if (!parseToken(T_HEADER, it)) return 0;
 
         std::size_t n = 0;
-        auto header_str = tokens[it].value;
+        auto header_str = tokens[it].str();
 
-        header_str = header_str.substr(8, tokens[it].value.length()-8-1);
+        header_str = header_str.substr(8, tokens[it].str().length()-8-1);
         while (header_str[n] == ' ' || header_str[n] == '\t') n++;
         auto version = header_str.substr(n, header_str.length()-n);
 
@@ -120,12 +152,35 @@ namespace kazm {
 
         if (!parseToken(T_INCLUDE, it) || !parseToken(T_FILENAME, it+1) || !parseToken(';', it+2)) return 0;
 
-        auto filename = tokens[it+1].value.substr(1, tokens[it+1].value.length()-2);
+        auto filename = tokens[it+1].str().substr(1, tokens[it+1].str().length()-2);
 
+        if (includes && install(filename)) return 3;
+
+        included.push_back(filename);
         parse(filename);
 
         return 3;
 
     }
 
+    bool Parser::install(const std::string& filename) {
+
+        auto library = includes->find(filename, qasm_version);
+        if (!library) return false;
+
+        for (Gate* g : library->gates) {
+            std::size_t id = symbols.find(g->name);
+            if (id != SymbolTable::npos && (isGate(id) || isCReg(id) || isQReg(id))) return false;
+        }
+
+        for (Gate* g : library->gates) {
+            std::size_t id = symbols.intern(g->name);
+            define(id);
+            gates[id] = g;
+        }
+        libraries.push_back(library);
+
+        return true;
+    }
+
 }
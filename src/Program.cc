@@ -1,10 +1,13 @@
 #include <sstream>
 
 #include <Program.h>
-#include <Data.h>
+#include <Register.h>
 #include <Expression.h>
 #include <Constant.h>
 #include <Instruction.h>
+#include <Expansion.h>
+#include <Backend.h>
+#include <Circuit.h>
 
 namespace kazm {
 
@@ -13,25 +16,163 @@ namespace kazm {
         std::stringstream ss;
 
         ss << "Program {\n";
+        if (param_names.size() > 0) {
+            ss << "    parameters ";
+            for (std::size_t i = 0; i < param_names.size(); i++) {
+                ss << param_names[i];
+                if (i != param_names.size()-1) ss << ", ";
+            }
+            ss << std::endl;
+        }
         for (std::size_t i = 0; i < instructions.size(); i++) {
             ss << "    " << instructions[i]->str() << std::endl;
         }
         ss << "}\n";
 
-        pstack.clear();
-        bstack.clear();
+        return ss.str();
+    }
 
+    std::string Program::str(Operand op) const {
+        std::stringstream ss;
+        ss << registers[op.reg()]->name();
+        if (!op.broadcast()) ss << "[" << op.index() << "]";
         return ss.str();
     }
 
-    void Program::run() {
+    std::size_t Program::addRegister(Register* reg) {
+        registers.push_back(reg);
+        reg_offsets.push_back(reg->offset());
+        reg_sizes.push_back(reg->size());
+        return registers.size() - 1;
+    }
 
-        for (std::size_t i = 0; i < instructions.size(); i++) {
-            instructions[i]->execute();
+    std::size_t Program::offset(Operand op) const {
+        return reg_offsets[op.reg()] + op.index();
+    }
+
+    std::size_t Program::size(Operand op) const {
+        return op.broadcast() ? reg_sizes[op.reg()] : 1;
+    }
+
+    std::string Program::checkOperands(std::size_t first, std::size_t count) const {
+
+        std::vector<Operand> regs;
+        std::vector<Operand> bits;
+
+        for (std::size_t i = first; i < first + count; i++) {
+            Operand op = operands[i];
+            if (op.broadcast()) regs.push_back(op);
+            else bits.push_back(op);
+        }
+
+        for (std::size_t i = 1; i < regs.size(); i++) {
+            if (size(regs[i]) != size(regs[0])) return "Register arguments must have the same size";
+        }
+
+        for (std::size_t i = 0; i < regs.size(); i++) {
+            for (std::size_t j = i+1; j < regs.size(); j++) {
+                if (regs[i].reg() == regs[j].reg()) return "Registers used in arguments must be unique";
+            }
+        }
+
+        for (std::size_t i = 0; i < bits.size(); i++) {
+            for (std::size_t j = i+1; j < bits.size(); j++) {
+                if (bits[i].word == bits[j].word) return "Qubit arguments must be unique";
+            }
+        }
+
+        for (std::size_t i = 0; i < bits.size(); i++) {
+            for (std::size_t j = 0; j < regs.size(); j++) {
+                if (bits[i].reg() == regs[j].reg()) return "Register " + registers[regs[j].reg()]->name() + " overlaps with a qubit argument";
+            }
+        }
+
+        return "";
+    }
+
+    std::string Program::checkMeasure(Operand qubit, Operand clbit) const {
+        if (qubit.broadcast() != clbit.broadcast() || size(qubit) != size(clbit)) return "Arguments of measure must both be registers of the same size or both be single bits";
+        return "";
+    }
+
+    std::size_t Program::param(std::size_t id) const {
+        if (id >= param_slots.size() || param_slots[id] == 0) return static_cast<std::size_t>(-1);
+        return param_slots[id] - 1;
+    }
+
+    void Program::mapParam(std::size_t id, std::size_t index) {
+        if (id >= param_slots.size()) param_slots.resize(id + 1, 0);
+        param_slots[id] = index + 1;
+    }
+
+    void Program::compile() {
+
+        for (std::size_t i = pcode.size(); i < pstack.size(); i++) {
+            pcode.push_back(Bytecode());
+            pstack[i]->compile(pcode.back());
+        }
+
+    }
+
+    void Program::bind(const std::vector<double>& values, std::vector<double>& pvalues) throw (Exception) {
+
+        if (values.size() != param_names.size()) {
+            std::stringstream ss;
+            ss << "Program expects " << param_names.size() << " parameter values, " << values.size() << " provided";
+            throw Exception(ss.str());
         }
 
-        pstack.clear();
-        bstack.clear();
+        {
+            std::lock_guard<std::mutex> lock(pcode_mutex);
+            compile();
+        }
+
+        pvalues.resize(pcode.size());
+        for (std::size_t i = 0; i < pcode.size(); i++) pvalues[i] = pcode[i].evaluate(values.data());
+
+    }
+
+    void Program::run(Backend& backend, const std::vector<double>& values) throw (Exception) {
+
+        std::vector<double> pvalues;
+        bind(values, pvalues);
+
+        backend.parameters = &pvalues;
+        run(backend);
+        backend.parameters = nullptr;
+
+    }
+
+    void Program::flatten(Circuit& circuit, const std::vector<double>& values) throw (Exception) {
+
+        std::vector<double> pvalues;
+        bind(values, pvalues);
+
+        Recorder recorder(circuit);
+        recorder.parameters = &pvalues;
+        run(recorder);
+
+    }
+
+    void Program::run(Backend& backend) {
+
+        bool active = true;
+
+        for (const Step& step : Expansion(*this)) {
+            if (step.guard && step.first()) active = step.guard->enter(backend);
+            if (active) step.execute(backend);
+            if (step.guard && step.last()) {
+                backend.endConditional();
+                active = true;
+            }
+        }
+
+    }
+
+    void Program::flatten(Circuit& circuit) {
+
+        Recorder recorder(circuit);
+        run(recorder);
 
     }
 
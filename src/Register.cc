@@ -4,11 +4,12 @@
 
 namespace kazm {
 
-    Register::Register(DataType t, const std::string& n, std::size_t s, std::size_t o):
+    Register::Register(DataType t, const std::string& n, std::size_t s, std::size_t o, std::size_t i):
         _type(t),
         _name(n),
         _size(s),
-        _offset(o)
+        _offset(o),
+        _index(i)
     {
     }
 
@@ -32,6 +33,10 @@ namespace kazm {
         return true;
     }
 
+    std::size_t Register::index() {
+        return _index;
+    }
+
     std::string Register::str() {
         std::stringstream ss;
         ss << (isClassical() ? "Classical register " : "Quantum register "); 
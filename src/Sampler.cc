@@ -0,0 +1,46 @@
+#include <Sampler.h>
+
+namespace kazm {
+
+    Sampler::Sampler(const std::vector<double>& weights):
+        threshold(weights.size(), 1.0),
+        alias(weights.size())
+    {
+        std::size_t n = weights.size();
+
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; i++) total += weights[i];
+
+        std::vector<std::size_t> small;
+        std::vector<std::size_t> large;
+        for (std::size_t i = 0; i < n; i++) {
+            alias[i] = i;
+            threshold[i] = total > 0.0 ? weights[i] * n / total : 1.0;
+            if (threshold[i] < 1.0) small.push_back(i);
+            else large.push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            std::size_t s = small.back();
+            std::size_t l = large.back();
+            small.pop_back();
+            alias[s] = l;
+            threshold[l] -= 1.0 - threshold[s];
+            if (threshold[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        for (std::size_t i = 0; i < small.size(); i++) threshold[small[i]] = 1.0;
+        for (std::size_t i = 0; i < large.size(); i++) threshold[large[i]] = 1.0;
+    }
+
+    std::size_t Sampler::draw(double u) const {
+        double x = u * threshold.size();
+        std::size_t i = static_cast<std::size_t>(x);
+        if (i >= threshold.size()) i = threshold.size() - 1;
+        return x - i < threshold[i] ? i : alias[i];
+    }
+
+}
@@ -88,7 +88,7 @@ class Scanner : public reflex::AbstractLexer<reflex::Matcher> {
 
 #include <iostream>
 
-#define RETURN(x)    return Token(x, str(), lineno())
+#define RETURN(x)    return Token(x, lineno())
 
 
 
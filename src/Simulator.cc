@@ -0,0 +1,385 @@
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <mutex>
+#include <memory>
+#include <exception>
+
+#include <Simulator.h>
+#include <Instruction.h>
+#include <StateVector.h>
+#include <ThreadPool.h>
+#include <Circuit.h>
+#include <Fusion.h>
+#include <Sampler.h>
+#include <Trajectories.h>
+#include <Stabilizer.h>
+#include <MPS.h>
+
+namespace kazm {
+
+    static const std::size_t trajectory_qubits = 16;
+
+    Simulator::Simulator(Program& p, std::size_t nq, std::size_t nc):
+        program(&p),
+        qubit_space(nq),
+        clbit_space(nc),
+        seed(0),
+        kernel(Kernels::Detect()),
+        threads(1),
+        fusion(0),
+        sampling(true),
+        backend(backend_statevector),
+        bond(64),
+        passes_before(0),
+        passes_after(0),
+        fusion_time(0.0),
+        run_time(0.0),
+        max_bond(0),
+        truncation(0.0)
+    {
+    }
+
+    void Simulator::check() const throw (Exception) {
+        for (Instruction* inst : program->instructions) {
+            if (inst->type == instruction_if) inst = dynamic_cast<IfInst*>(inst)->inst;
+            if (inst->type != instruction_call) continue;
+            const Gate* opaque = dynamic_cast<CallInst*>(inst)->gate->opaque;
+            if (opaque) throw Exception("Gate " + opaque->name + " is opaque and cannot be simulated");
+        }
+    }
+
+    std::string Simulator::outcome(const Backend& backend) {
+        std::string s(clbit_space, '0');
+        for (std::size_t i = 0; i < clbit_space; i++) {
+            if (backend.getClbit(i)) s[clbit_space-1-i] = '1';
+        }
+        return s;
+    }
+
+    std::map<std::string, std::size_t> Simulator::sample(const std::vector<Operation>& measures, std::size_t shots, StateVector& state) {
+
+        std::map<std::string, std::size_t> counts;
+
+        std::vector<std::size_t> qubits;
+        std::vector<std::size_t> position(qubit_space, qubit_space);
+        for (std::size_t i = 0; i < measures.size(); i++) {
+            if (measures[i].type != operation_measure) continue;
+            std::size_t q = measures[i].qubits[0];
+            if (position[q] != qubit_space) continue;
+            position[q] = qubits.size();
+            qubits.push_back(q);
+        }
+
+        std::vector<double> weights;
+        state.distribution(qubits, weights);
+        Sampler sampler(weights);
+
+        std::vector<std::size_t> hits(weights.size(), 0);
+        for (std::size_t i = 0; i < shots; i++) hits[sampler.draw(state.random())]++;
+
+        for (std::size_t key = 0; key < hits.size(); key++) {
+            if (hits[key] == 0) continue;
+            std::string s(clbit_space, '0');
+            for (std::size_t i = 0; i < measures.size(); i++) {
+                if (measures[i].type != operation_measure) continue;
+                bool bit = (key >> position[measures[i].qubits[0]]) & 1;
+                s[clbit_space-1-measures[i].clbit] = bit ? '1' : '0';
+            }
+            counts[s] += hits[key];
+        }
+
+        return counts;
+    }
+
+    std::map<std::string, std::size_t> Simulator::run(std::size_t shots) {
+
+        std::map<std::string, std::size_t> counts;
+
+        if (program->param_names.size() > 0) throw Exception("Program has free parameters, values must be bound with a parameter sweep");
+        if (backend == backend_stabilizer) return stabilizer(shots);
+        if (backend == backend_mps) return mps(shots);
+        check();
+
+        ThreadPool pool(threads);
+        StateVector state(qubit_space, clbit_space, &pool);
+        state.seed(seed);
+        state.kernel = kernel;
+
+        auto start = std::chrono::steady_clock::now();
+        Circuit flat(qubit_space, clbit_space);
+        Circuit fused(qubit_space, clbit_space);
+        std::vector<Operation> measures;
+        std::size_t first = 0;
+        bool terminal = false;
+        if (sampling || fusion > 0) {
+            program->flatten(flat);
+            terminal = sampling && flat.terminal(first);
+            if (terminal) {
+                measures.assign(flat.operations.begin() + first, flat.operations.end());
+                flat.operations.erase(flat.operations.begin() + first, flat.operations.end());
+            }
+        }
+        if (fusion > 0) {
+            Fusion(fusion, kernel).run(flat, fused);
+            passes_before = flat.passes();
+            passes_after = fused.passes();
+            fusion_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        const Circuit& circuit = fusion > 0 ? fused : flat;
+
+        start = std::chrono::steady_clock::now();
+        if (terminal) {
+            state.init();
+            circuit.run(state);
+            counts = sample(measures, shots, state);
+        }
+        else {
+            std::size_t workers = threads > 1 && qubit_space <= trajectory_qubits ? pool.nthreads : 1;
+            ThreadPool serial(1);
+            Trajectories trajectories(workers > 1 ? pool : serial, 64);
+            std::vector<std::unique_ptr<StateVector> > owned;
+            std::vector<StateVector*> states(workers, &state);
+            std::vector<std::map<std::string, std::size_t> > histograms(workers);
+            for (std::size_t w = 0; w < workers && workers > 1; w++) {
+                owned.emplace_back(new StateVector(qubit_space, clbit_space));
+                owned.back()->kernel = kernel;
+                states[w] = owned.back().get();
+            }
+            trajectories.run(shots, [&](std::size_t w, std::size_t begin, std::size_t end) {
+                StateVector& s = *states[w];
+                s.seed(Trajectories::Seed(seed, begin));
+                for (std::size_t i = begin; i < end; i++) {
+                    s.init();
+                    if (fusion == 0) program->run(s);
+                    else circuit.run(s);
+                    histograms[w][outcome(s)]++;
+                }
+            });
+            for (std::size_t w = 0; w < workers; w++) {
+                for (auto it = histograms[w].begin(); it != histograms[w].end(); ++it) counts[it->first] += it->second;
+            }
+        }
+        run_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return counts;
+    }
+
+    std::map<std::string, std::size_t> Simulator::stabilizer(std::size_t shots) {
+
+        std::map<std::string, std::size_t> counts;
+
+        if (fusion > 0) throw Exception("Gate fusion is not supported by the stabilizer backend");
+        check();
+
+        Circuit flat(qubit_space, clbit_space);
+        Circuit measures(qubit_space, clbit_space);
+        program->flatten(flat);
+
+        for (std::size_t i = 0; i < flat.operations.size(); i++) {
+            const Operation& op = flat.operations[i];
+            if (op.type != operation_u || Stabilizer::IsClifford(op.params[0], op.params[1], op.params[2])) continue;
+            std::stringstream ss;
+            ss << "U(" << op.params[0] << ", " << op.params[1] << ", " << op.params[2] << ") on qubit " << op.qubits[0] << " is not a Clifford gate, cannot use the stabilizer backend";
+            throw Exception(ss.str());
+        }
+
+        std::size_t first = 0;
+        bool terminal = sampling && flat.terminal(first);
+        if (terminal) {
+            measures.operations.assign(flat.operations.begin() + first, flat.operations.end());
+            flat.operations.erase(flat.operations.begin() + first, flat.operations.end());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        Stabilizer prefix(qubit_space, clbit_space);
+        if (terminal) flat.run(prefix);
+
+        ThreadPool pool(threads);
+        Trajectories trajectories(pool, 64);
+        std::vector<std::unique_ptr<Stabilizer> > states(pool.nthreads);
+        std::vector<std::map<std::string, std::size_t> > histograms(pool.nthreads);
+        for (std::size_t w = 0; w < pool.nthreads; w++) states[w].reset(new Stabilizer(qubit_space, clbit_space));
+
+        trajectories.run(shots, [&](std::size_t w, std::size_t begin, std::size_t end) {
+            Stabilizer& s = *states[w];
+            s.seed(Trajectories::Seed(seed, begin));
+            for (std::size_t i = begin; i < end; i++) {
+                if (terminal) {
+                    s.assign(prefix);
+                    measures.run(s);
+                }
+                else {
+                    s.init();
+                    flat.run(s);
+                }
+                histograms[w][outcome(s)]++;
+            }
+        });
+
+        for (std::size_t w = 0; w < pool.nthreads; w++) {
+            for (auto it = histograms[w].begin(); it != histograms[w].end(); ++it) counts[it->first] += it->second;
+        }
+
+        run_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return counts;
+    }
+
+    std::map<std::string, std::size_t> Simulator::mps(std::size_t shots) {
+
+        std::map<std::string, std::size_t> counts;
+
+        if (fusion > 0) throw Exception("Gate fusion is not supported by the MPS backend");
+        if (bond == 0) throw Exception("Bond dimension of the MPS backend must be positive");
+        check();
+
+        Circuit flat(qubit_space, clbit_space);
+        Circuit measures(qubit_space, clbit_space);
+        std::size_t first = 0;
+        bool terminal = false;
+        if (sampling) {
+            program->flatten(flat);
+            terminal = flat.terminal(first);
+            if (terminal) {
+                measures.operations.assign(flat.operations.begin() + first, flat.operations.end());
+                flat.operations.erase(flat.operations.begin() + first, flat.operations.end());
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        MPS prefix(qubit_space, clbit_space, bond);
+        std::size_t sites = 0;
+        if (terminal) {
+            flat.run(prefix);
+            prefix.move(0);
+            for (const Operation& op : measures.operations) {
+                if (op.type == operation_measure) sites = std::max(sites, op.qubits[0] + 1);
+            }
+        }
+
+        ThreadPool pool(threads);
+        Trajectories trajectories(pool, 64);
+        std::vector<std::unique_ptr<MPS> > states(pool.nthreads);
+        std::vector<std::map<std::string, std::size_t> > histograms(pool.nthreads);
+        for (std::size_t w = 0; w < pool.nthreads; w++) states[w].reset(new MPS(qubit_space, clbit_space, bond));
+
+        trajectories.run(shots, [&](std::size_t w, std::size_t begin, std::size_t end) {
+            MPS& s = *states[w];
+            std::vector<uint8_t> bits;
+            s.seed(Trajectories::Seed(seed, begin));
+            for (std::size_t i = begin; i < end; i++) {
+                if (terminal) {
+                    s.draw(prefix, sites, bits);
+                    for (const Operation& op : measures.operations) {
+                        if (op.type == operation_measure) s.setClbit(op.clbit, bits[op.qubits[0]]);
+                    }
+                }
+                else {
+                    s.init();
+                    program->run(s);
+                }
+                histograms[w][outcome(s)]++;
+            }
+        });
+
+        max_bond = prefix.max_bond;
+        truncation = prefix.max_truncation;
+        for (std::size_t w = 0; w < pool.nthreads; w++) {
+            for (auto it = histograms[w].begin(); it != histograms[w].end(); ++it) counts[it->first] += it->second;
+            max_bond = std::max(max_bond, states[w]->max_bond);
+            truncation = std::max(truncation, states[w]->max_truncation);
+        }
+
+        run_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return counts;
+    }
+
+    std::vector<std::map<std::string, std::size_t> > Simulator::sweep(const std::vector<std::vector<double> >& sets, std::size_t shots) {
+
+        std::vector<std::map<std::string, std::size_t> > counts(sets.size());
+        std::vector<std::vector<double> > pvalues(sets.size());
+
+        if (backend == backend_stabilizer) throw Exception("Parameter sweeps are not supported by the stabilizer backend");
+        if (backend == backend_mps) throw Exception("Parameter sweeps are not supported by the MPS backend");
+        check();
+
+        for (std::size_t s = 0; s < sets.size(); s++) program->bind(sets[s], pvalues[s]);
+
+        ThreadPool pool(threads);
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::function<void(std::size_t)> task = [&](std::size_t id) {
+            std::size_t begin, end;
+            ThreadPool::Split(sets.size(), pool.nthreads, id, 1, begin, end);
+            if (begin == end) return;
+            try {
+                StateVector state(qubit_space, clbit_space);
+                state.kernel = kernel;
+                for (std::size_t s = begin; s < end; s++) {
+                    state.seed(seed + s);
+                    state.parameters = &pvalues[s];
+                    Circuit flat(qubit_space, clbit_space);
+                    Circuit fused(qubit_space, clbit_space);
+                    std::vector<Operation> measures;
+                    std::size_t first = 0;
+                    bool terminal = false;
+                    if (sampling || fusion > 0) {
+                        program->flatten(flat, sets[s]);
+                        terminal = sampling && flat.terminal(first);
+                        if (terminal) {
+                            measures.assign(flat.operations.begin() + first, flat.operations.end());
+                            flat.operations.erase(flat.operations.begin() + first, flat.operations.end());
+                        }
+                    }
+                    if (fusion > 0) Fusion(fusion, kernel).run(flat, fused);
+                    const Circuit& circuit = fusion > 0 ? fused : flat;
+                    if (terminal) {
+                        state.init();
+                        circuit.run(state);
+                        counts[s] = sample(measures, shots, state);
+                    }
+                    else if (fusion == 0) {
+                        for (std::size_t i = 0; i < shots; i++) {
+                            state.init();
+                            program->run(state);
+                            counts[s][outcome(state)]++;
+                        }
+                    }
+                    else {
+                        for (std::size_t i = 0; i < shots; i++) {
+                            state.init();
+                            circuit.run(state);
+                            counts[s][outcome(state)]++;
+                        }
+                    }
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        };
+        pool.run(task);
+
+        run_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (error) std::rethrow_exception(error);
+
+        return counts;
+    }
+
+    BackendType Simulator::GetBackend(const std::string& name) throw (Exception) {
+        if (name == "statevector") return backend_statevector;
+        if (name == "stabilizer") return backend_stabilizer;
+        if (name == "mps") return backend_mps;
+        throw Exception("Unknown backend " + name);
+    }
+
+}
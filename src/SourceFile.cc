@@ -1,16 +1,79 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include <SourceFile.h>
 
 namespace kazm {
 
-    SourceFile::SourceFile(const std::string& f) throw (Exception): 
+    SourceFile::SourceFile(const std::string& f, SymbolTable& s) throw (Exception): 
         filename(f),
-        file(filename)
+        data(nullptr),
+        size(0),
+        start(0),
+        line(0),
+        mapped(false),
+        symbols(&s)
     {
-        if (!file.is_open()) throw Exception("Unable to open " + filename);
-        lexer.in() = file;
-    }	
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw Exception("Unable to open " + filename);
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, st.st_size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(p);
+                size = st.st_size;
+                mapped = true;
+            }
+        }
+
+        if (!mapped) {
+            char buf[65536];
+            ssize_t n;
+            while ((n = read(fd, buf, sizeof(buf))) > 0) contents.append(buf, n);
+            if (n < 0) {
+                close(fd);
+                throw Exception("Unable to read " + filename);
+            }
+            data = contents.data();
+            size = contents.size();
+        }
+
+        close(fd);
+        lexer.in() = reflex::Input(data, size);
+    }
+
+    SourceFile::SourceFile(const std::string& f, const char* d, std::size_t s, SymbolTable& st):
+        filename(f),
+        data(d),
+        size(s),
+        start(0),
+        line(0),
+        mapped(false),
+        symbols(&st)
+    {
+        lexer.in() = reflex::Input(data, size);
+    }
+
+    SourceFile::~SourceFile() {
+        if (mapped) munmap(const_cast<char*>(data), size);
+    }
     
+    void SourceFile::seek(std::size_t pos, int l) {
+        start = pos;
+        line = l - 1;
+        lexer.in(reflex::Input(data + pos, size - pos));
+    }
+
     Token SourceFile::scan() {
-        return lexer.scan();
+        Token t = lexer.scan();
+        t.text = data + start + lexer.matcher().first();
+        t.line += line;
+        t.size = lexer.matcher().size();
+        if (t.type == T_ID) t.id = symbols->intern(t.text, t.size);
+        return t;
     }
 }
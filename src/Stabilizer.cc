@@ -0,0 +1,225 @@
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+
+#include <Stabilizer.h>
+
+namespace kazm {
+
+    Stabilizer::Stabilizer(std::size_t nq, std::size_t nc):
+        Backend(nq, nc),
+        rows(2*nq + 1),
+        words((nq + 63) / 64),
+        x(rows * words, 0),
+        z(rows * words, 0),
+        r(rows, 0)
+    {
+        init();
+    }
+
+    void Stabilizer::init() {
+
+        Backend::init();
+
+        std::fill(x.begin(), x.end(), 0);
+        std::fill(z.begin(), z.end(), 0);
+        std::fill(r.begin(), r.end(), 0);
+
+        for (std::size_t q = 0; q < nqubits; q++) {
+            x[q*words + q/64] |= uint64_t(1) << (q%64);
+            z[(nqubits+q)*words + q/64] |= uint64_t(1) << (q%64);
+        }
+    }
+
+    void Stabilizer::assign(const Stabilizer& other) {
+        x = other.x;
+        z = other.z;
+        r = other.r;
+        clbits = other.clbits;
+    }
+
+    bool Stabilizer::Quarter(double angle, unsigned& k) {
+        double t = angle / (M_PI/2.0);
+        double n = std::round(t);
+        if (std::fabs(t - n) > 1e-9) return false;
+        long m = static_cast<long>(n) % 4;
+        k = static_cast<unsigned>(m < 0 ? m + 4 : m);
+        return true;
+    }
+
+    bool Stabilizer::IsClifford(double theta, double phi, double lambda) {
+        unsigned k;
+        return Quarter(theta, k) && Quarter(phi, k) && Quarter(lambda, k);
+    }
+
+    void Stabilizer::h(std::size_t q) {
+        std::size_t w = q/64;
+        uint64_t m = uint64_t(1) << (q%64);
+        for (std::size_t i = 0; i < 2*nqubits; i++) {
+            uint64_t& xi = x[i*words + w];
+            uint64_t& zi = z[i*words + w];
+            uint64_t xb = xi & m;
+            uint64_t zb = zi & m;
+            r[i] ^= (xb && zb);
+            xi = (xi & ~m) | zb;
+            zi = (zi & ~m) | xb;
+        }
+    }
+
+    void Stabilizer::s(std::size_t q) {
+        std::size_t w = q/64;
+        uint64_t m = uint64_t(1) << (q%64);
+        for (std::size_t i = 0; i < 2*nqubits; i++) {
+            uint64_t xb = x[i*words + w] & m;
+            r[i] ^= (xb && (z[i*words + w] & m));
+            z[i*words + w] ^= xb;
+        }
+    }
+
+    void Stabilizer::xgate(std::size_t q) {
+        std::size_t w = q/64;
+        uint64_t m = uint64_t(1) << (q%64);
+        for (std::size_t i = 0; i < 2*nqubits; i++) r[i] ^= (z[i*words + w] & m) != 0;
+    }
+
+    void Stabilizer::u(std::size_t q, double theta, double phi, double lambda) {
+
+        unsigned t, p, l;
+        if (!Quarter(theta, t) || !Quarter(phi, p) || !Quarter(lambda, l)) {
+            std::stringstream ss;
+            ss << "U(" << theta << ", " << phi << ", " << lambda << ") on qubit " << q << " is not a Clifford gate";
+            throw Exception(ss.str());
+        }
+
+        clifford(q, t, p, l);
+    }
+
+    void Stabilizer::clifford(std::size_t q, unsigned t, unsigned p, unsigned l) {
+
+        unsigned table[4];
+        for (unsigned b = 0; b < 4; b++) {
+            unsigned xb = b & 1, zb = b >> 1, sign = 0;
+            for (unsigned i = 0; i < l; i++) {
+                sign ^= xb & zb;
+                zb ^= xb;
+            }
+            for (unsigned i = 0; i < t; i++) {
+                sign ^= xb & zb;
+                zb ^= xb;
+                sign ^= xb & zb;
+                zb ^= xb;
+                sign ^= xb & zb;
+                std::swap(xb, zb);
+            }
+            for (unsigned i = 0; i < p; i++) {
+                sign ^= xb & zb;
+                zb ^= xb;
+            }
+            table[b] = xb | (zb << 1) | (sign << 2);
+        }
+
+        std::size_t w = q/64;
+        unsigned shift = q%64;
+        uint64_t m = uint64_t(1) << shift;
+        for (std::size_t i = 0; i < 2*nqubits; i++) {
+            uint64_t& xi = x[i*words + w];
+            uint64_t& zi = z[i*words + w];
+            unsigned b = ((xi >> shift) & 1) | (((zi >> shift) & 1) << 1);
+            unsigned e = table[b];
+            xi = (xi & ~m) | (uint64_t(e & 1) << shift);
+            zi = (zi & ~m) | (uint64_t((e >> 1) & 1) << shift);
+            r[i] ^= e >> 2;
+        }
+    }
+
+    void Stabilizer::cx(std::size_t c, std::size_t t) {
+        std::size_t cw = c/64;
+        std::size_t tw = t/64;
+        uint64_t cm = uint64_t(1) << (c%64);
+        uint64_t tm = uint64_t(1) << (t%64);
+        for (std::size_t i = 0; i < 2*nqubits; i++) {
+            uint64_t* xi = &x[i*words];
+            uint64_t* zi = &z[i*words];
+            bool xc = xi[cw] & cm;
+            bool zc = zi[cw] & cm;
+            bool xt = xi[tw] & tm;
+            bool zt = zi[tw] & tm;
+            r[i] ^= xc && zt && (xt == zc);
+            if (xc) xi[tw] ^= tm;
+            if (zt) zi[cw] ^= cm;
+        }
+    }
+
+    void Stabilizer::rowsum(std::size_t h, std::size_t i) {
+
+        uint64_t* xh = &x[h*words];
+        uint64_t* zh = &z[h*words];
+        const uint64_t* xi = &x[i*words];
+        const uint64_t* zi = &z[i*words];
+
+        uint64_t c1 = 0, c2 = 0;
+        for (std::size_t w = 0; w < words; w++) {
+            uint64_t x1 = xh[w], z1 = zh[w], x2 = xi[w], z2 = zi[w];
+            uint64_t nx = x1 ^ x2;
+            uint64_t nz = z1 ^ z2;
+            uint64_t x1z2 = x1 & z2;
+            uint64_t anti = (x2 & z1) ^ x1z2;
+            c2 ^= (c1 ^ nx ^ nz ^ x1z2) & anti;
+            c1 ^= anti;
+            xh[w] = nx;
+            zh[w] = nz;
+        }
+
+        unsigned s = __builtin_popcountll(c1) + 2*__builtin_popcountll(c2);
+        r[h] ^= r[i] ^ ((s >> 1) & 1);
+    }
+
+    void Stabilizer::rowcopy(std::size_t h, std::size_t i) {
+        std::copy(&x[i*words], &x[i*words] + words, &x[h*words]);
+        std::copy(&z[i*words], &z[i*words] + words, &z[h*words]);
+        r[h] = r[i];
+    }
+
+    void Stabilizer::rowclear(std::size_t h) {
+        std::fill(&x[h*words], &x[h*words] + words, 0);
+        std::fill(&z[h*words], &z[h*words] + words, 0);
+        r[h] = 0;
+    }
+
+    bool Stabilizer::sample(std::size_t a) {
+
+        std::size_t n = nqubits;
+        std::size_t w = a/64;
+        uint64_t m = uint64_t(1) << (a%64);
+
+        std::size_t p = n;
+        while (p < 2*n && !(x[p*words + w] & m)) p++;
+
+        if (p < 2*n) {
+            for (std::size_t i = 0; i < 2*n; i++) {
+                if (i != p && (x[i*words + w] & m)) rowsum(i, p);
+            }
+            rowcopy(p-n, p);
+            rowclear(p);
+            z[p*words + w] |= m;
+            r[p] = random() < 0.5;
+            return r[p];
+        }
+
+        std::size_t scratch = 2*n;
+        rowclear(scratch);
+        for (std::size_t i = 0; i < n; i++) {
+            if (x[i*words + w] & m) rowsum(scratch, i+n);
+        }
+        return r[scratch];
+    }
+
+    void Stabilizer::measure(std::size_t q, std::size_t c) {
+        setClbit(c, sample(q));
+    }
+
+    void Stabilizer::reset(std::size_t q) {
+        if (sample(q)) xgate(q);
+    }
+
+}
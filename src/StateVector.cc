@@ -0,0 +1,198 @@
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+
+#include <StateVector.h>
+
+namespace kazm {
+
+    StateVector::StateVector(std::size_t nq, std::size_t nc, ThreadPool* tp) throw (Exception):
+        Backend(nq, nc),
+        size(0),
+        kernel(Kernels::Detect()),
+        pool(tp),
+        amplitudes(nullptr)
+    {
+        if (nq >= 8*sizeof(std::size_t) - 5) {
+            std::stringstream ss;
+            ss << "Unable to simulate " << nq << " qubits using a state vector";
+            throw Exception(ss.str());
+        }
+        size = std::size_t(1) << nq;
+
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, 64, size * sizeof(std::complex<double>)) != 0) {
+            std::stringstream ss;
+            ss << "Unable to allocate the state vector for " << nq << " qubits";
+            throw Exception(ss.str());
+        }
+        amplitudes = static_cast<std::complex<double>*>(buffer);
+
+        init();
+    }
+
+    StateVector::~StateVector() {
+        free(amplitudes);
+    }
+
+    void StateVector::parallel(std::size_t n, const std::function<void(std::size_t, std::size_t)>& f) {
+
+        if (!pool || pool->nthreads == 1 || n < 4096) {
+            f(0, n);
+            return;
+        }
+
+        pool->run([&](std::size_t id) {
+            std::size_t b, e;
+            ThreadPool::Split(n, pool->nthreads, id, 8, b, e);
+            if (b < e) f(b, e);
+        });
+    }
+
+    double StateVector::reduce(std::size_t n, const std::function<double(std::size_t, std::size_t)>& f) {
+
+        if (!pool || pool->nthreads == 1 || n < 4096) return f(0, n);
+
+        std::vector<double> partial(8*pool->nthreads, 0.0);
+        pool->run([&](std::size_t id) {
+            std::size_t b, e;
+            ThreadPool::Split(n, pool->nthreads, id, 8, b, e);
+            if (b < e) partial[8*id] = f(b, e);
+        });
+
+        double sum = 0.0;
+        for (std::size_t i = 0; i < pool->nthreads; i++) sum += partial[8*i];
+        return sum;
+    }
+
+    void StateVector::init() {
+        Backend::init();
+        parallel(size, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; i++) amplitudes[i] = 0.0;
+        });
+        amplitudes[0] = 1.0;
+    }
+
+    void StateVector::u(std::size_t q, double theta, double phi, double lambda) {
+
+        double m[8];
+        Kernels::UMatrix(theta, phi, lambda, m);
+
+        parallel(size/2, [&](std::size_t b, std::size_t e) {
+            Kernels::ApplyU(kernel, amplitudes, q, m, b, e);
+        });
+    }
+
+    void StateVector::cx(std::size_t c, std::size_t t) {
+        parallel(size/4, [&](std::size_t b, std::size_t e) {
+            Kernels::ApplyCX(kernel, amplitudes, c, t, b, e);
+        });
+    }
+
+    void StateVector::x(std::size_t q) {
+
+        std::size_t mask = (std::size_t(1) << q) - 1;
+        std::size_t stride = std::size_t(1) << q;
+
+        parallel(size/2, [&](std::size_t b, std::size_t e) {
+            for (std::size_t k = b; k < e; k++) {
+                std::size_t j = ((k & ~mask) << 1) | (k & mask);
+                std::swap(amplitudes[j], amplitudes[j+stride]);
+            }
+        });
+    }
+
+    double StateVector::probability(std::size_t q) {
+
+        std::size_t mask = (std::size_t(1) << q) - 1;
+        std::size_t stride = std::size_t(1) << q;
+
+        return reduce(size/2, [&](std::size_t b, std::size_t e) {
+            double p = 0.0;
+            for (std::size_t k = b; k < e; k++) p += std::norm(amplitudes[(((k & ~mask) << 1) | (k & mask)) + stride]);
+            return p;
+        });
+    }
+
+    void StateVector::distribution(const std::vector<std::size_t>& qubits, std::vector<double>& weights) {
+
+        weights.assign(std::size_t(1) << qubits.size(), 0.0);
+
+        bool identity = qubits.size() == nqubits;
+        for (std::size_t j = 0; j < qubits.size() && identity; j++) identity = qubits[j] == j;
+
+        if (identity) {
+            for (std::size_t i = 0; i < size; i++) weights[i] = std::norm(amplitudes[i]);
+            return;
+        }
+
+        for (std::size_t i = 0; i < size; i++) {
+            std::size_t key = 0;
+            for (std::size_t j = 0; j < qubits.size(); j++) key |= ((i >> qubits[j]) & 1) << j;
+            weights[key] += std::norm(amplitudes[i]);
+        }
+    }
+
+    void StateVector::collapse(std::size_t q, bool outcome, double p) {
+
+        std::size_t mask = std::size_t(1) << q;
+        double norm = 1.0/sqrt(p);
+
+        parallel(size, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; i++) {
+                if (((i & mask) != 0) == outcome) amplitudes[i] *= norm;
+                else amplitudes[i] = 0.0;
+            }
+        });
+    }
+
+    bool StateVector::sample(std::size_t q) {
+
+        double p1 = probability(q);
+        bool outcome = random() < p1;
+        collapse(q, outcome, outcome ? p1 : 1.0 - p1);
+        return outcome;
+    }
+
+    void StateVector::measure(std::size_t q, std::size_t c) {
+        setClbit(c, sample(q));
+    }
+
+    void StateVector::reset(std::size_t q) {
+        if (sample(q)) x(q);
+    }
+
+    void StateVector::unitary(const std::vector<std::size_t>& qubits, const std::vector<std::complex<double> >& matrix) {
+
+        std::size_t k = qubits.size();
+        std::size_t dim = std::size_t(1) << k;
+
+        if (k == 1) {
+            double m[8];
+            for (std::size_t i = 0; i < 4; i++) {
+                m[2*i]   = matrix[i].real();
+                m[2*i+1] = matrix[i].imag();
+            }
+            parallel(size/2, [&](std::size_t b, std::size_t e) {
+                Kernels::ApplyU(kernel, amplitudes, qubits[0], m, b, e);
+            });
+            return;
+        }
+
+        std::vector<std::size_t> sorted(qubits);
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<std::size_t> offsets(dim, 0);
+        for (std::size_t l = 0; l < dim; l++) {
+            for (std::size_t i = 0; i < k; i++) {
+                if ((l >> i) & 1) offsets[l] |= std::size_t(1) << qubits[i];
+            }
+        }
+
+        parallel(size >> k, [&](std::size_t b, std::size_t e) {
+            Kernels::ApplyUnitary(kernel, amplitudes, k, sorted.data(), offsets.data(), matrix.data(), b, e);
+        });
+    }
+
+}
@@ -0,0 +1,74 @@
+#include <cstring>
+
+#include <SymbolTable.h>
+
+namespace kazm {
+
+    const std::size_t SymbolTable::npos;
+
+    SymbolTable::SymbolTable():
+        _slots(64, npos)
+    {
+    }
+
+    uint64_t SymbolTable::Hash(const char* s, std::size_t n) {
+        uint64_t h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < n; i++) {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    std::size_t SymbolTable::probe(const char* s, std::size_t n, uint64_t h) const {
+        std::size_t mask = _slots.size() - 1;
+        std::size_t i = h & mask;
+        while (true) {
+            std::size_t id = _slots[i];
+            if (id == npos) return i;
+            if (_hashes[id] == h && _names[id].size() == n && memcmp(_names[id].data(), s, n) == 0) return i;
+            i = (i + 1) & mask;
+        }
+    }
+
+    void SymbolTable::grow() {
+        std::vector<std::size_t> slots(2 * _slots.size(), npos);
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t id = 0; id < _names.size(); id++) {
+            std::size_t i = _hashes[id] & mask;
+            while (slots[i] != npos) i = (i + 1) & mask;
+            slots[i] = id;
+        }
+        _slots.swap(slots);
+    }
+
+    std::size_t SymbolTable::intern(const char* s, std::size_t n) {
+        uint64_t h = Hash(s, n);
+        std::size_t i = probe(s, n, h);
+        if (_slots[i] != npos) return _slots[i];
+
+        std::size_t id = _names.size();
+        _names.push_back(std::string(s, n));
+        _hashes.push_back(h);
+        _slots[i] = id;
+        if (2 * _names.size() > _slots.size()) grow();
+        return id;
+    }
+
+    std::size_t SymbolTable::intern(const std::string& s) {
+        return intern(s.data(), s.size());
+    }
+
+    std::size_t SymbolTable::find(const std::string& s) const {
+        return _slots[probe(s.data(), s.size(), Hash(s.data(), s.size()))];
+    }
+
+    const std::string& SymbolTable::name(std::size_t id) const {
+        return _names[id];
+    }
+
+    std::size_t SymbolTable::size() const {
+        return _names.size();
+    }
+
+}
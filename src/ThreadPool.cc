@@ -0,0 +1,87 @@
+#include <exception>
+
+#include <ThreadPool.h>
+
+namespace kazm {
+
+    ThreadPool::ThreadPool(std::size_t n):
+        _task(nullptr),
+        _generation(0),
+        _pending(0),
+        _stop(false),
+        nthreads(n == 0 ? 1 : n)
+    {
+        for (std::size_t i = 1; i < nthreads; i++) _workers.emplace_back(&ThreadPool::work, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _start.notify_all();
+        for (std::size_t i = 0; i < _workers.size(); i++) _workers[i].join();
+    }
+
+    void ThreadPool::work(std::size_t id) {
+
+        std::size_t seen = 0;
+
+        while (true) {
+            for (std::size_t spin = 0; spin < 4096 && _generation.load() == seen; spin++) std::this_thread::yield();
+            if (_generation.load() == seen) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start.wait(lock, [&] { return _stop || _generation.load() != seen; });
+                if (_stop) return;
+            }
+            seen = _generation.load();
+            (*_task)(id);
+            if (_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::run(const std::function<void(std::size_t)>& task) {
+
+        if (nthreads == 1) {
+            task(0);
+            return;
+        }
+
+        _task = &task;
+        _pending.store(nthreads-1);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _generation.fetch_add(1);
+        }
+        _start.notify_all();
+
+        std::exception_ptr error;
+        try {
+            task(0);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        for (std::size_t spin = 0; spin < 4096 && _pending.load() != 0; spin++) std::this_thread::yield();
+        if (_pending.load() != 0) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [&] { return _pending.load() == 0; });
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    void ThreadPool::Split(std::size_t n, std::size_t parts, std::size_t id, std::size_t align, std::size_t& begin, std::size_t& end) {
+
+        std::size_t chunk = (n + parts - 1) / parts;
+        chunk = (chunk + align - 1) / align * align;
+
+        begin = id * chunk < n ? id * chunk : n;
+        end = begin + chunk < n ? begin + chunk : n;
+    }
+
+}
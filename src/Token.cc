@@ -4,16 +4,24 @@ namespace kazm {
 
     Token::Token():
         type(T_UNDEF),
-        value(""),
+        text(nullptr),
+        size(0),
+        id(0),
         line(0)
     {
     }
     
-    Token::Token(int t, const std::string& v, int l):
+    Token::Token(int t, int l):
         type(t),
-        value(v),
+        text(nullptr),
+        size(0),
+        id(0),
         line(l)
     {
     }
 
+    std::string Token::str() const {
+        return std::string(text, size);
+    }
+
 }
@@ -0,0 +1,32 @@
+#include <TokenWindow.h>
+
+namespace kazm {
+
+    TokenWindow::TokenWindow()
+    {
+    }
+
+    Token& TokenWindow::operator[](std::size_t i) {
+        return _tokens[i];
+    }
+
+    std::size_t TokenWindow::size() {
+        return _tokens.size();
+    }
+
+    void TokenWindow::push_back(Token&& t) {
+        _tokens.push_back(std::move(t));
+    }
+
+    void TokenWindow::pop_back() {
+        _tokens.pop_back();
+    }
+
+    void TokenWindow::release(std::size_t s, std::size_t n) {
+        if (s == 0) {
+            for (std::size_t i = 0; i < n; i++) _tokens.pop_front();
+        }
+        else _tokens.erase(_tokens.begin()+s, _tokens.begin()+s+n);
+    }
+
+}
@@ -0,0 +1,90 @@
+#include <mutex>
+#include <exception>
+
+#include <Trajectories.h>
+
+namespace kazm {
+
+    Trajectories::Trajectories(ThreadPool& p, std::size_t g):
+        _pool(&p),
+        _queues(new Queue[p.nthreads]),
+        grain(g == 0 ? 1 : g)
+    {
+    }
+
+    bool Trajectories::pop(std::size_t id, std::size_t& chunk) {
+
+        std::atomic<uint64_t>& range = _queues[id].range;
+        uint64_t r = range.load();
+
+        while (true) {
+            uint64_t head = r >> 32;
+            uint64_t tail = r & 0xffffffffULL;
+            if (head >= tail) return false;
+            if (range.compare_exchange_weak(r, ((head + 1) << 32) | tail)) {
+                chunk = head;
+                return true;
+            }
+        }
+    }
+
+    bool Trajectories::steal(std::size_t id, std::size_t& chunk) {
+
+        for (std::size_t k = 1; k < _pool->nthreads; k++) {
+            std::atomic<uint64_t>& range = _queues[(id + k) % _pool->nthreads].range;
+            uint64_t r = range.load();
+            while (true) {
+                uint64_t head = r >> 32;
+                uint64_t tail = r & 0xffffffffULL;
+                if (head >= tail) break;
+                if (range.compare_exchange_weak(r, (head << 32) | (tail - 1))) {
+                    chunk = tail - 1;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void Trajectories::run(std::size_t shots, const std::function<void(std::size_t, std::size_t, std::size_t)>& batch) {
+
+        std::size_t size = grain;
+        while ((shots + size - 1) / size > 0xffffffffULL) size *= 2;
+        std::size_t chunks = (shots + size - 1) / size;
+
+        for (std::size_t id = 0; id < _pool->nthreads; id++) {
+            std::size_t begin, end;
+            ThreadPool::Split(chunks, _pool->nthreads, id, 1, begin, end);
+            _queues[id].range.store((uint64_t(begin) << 32) | uint64_t(end));
+        }
+
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        _pool->run([&](std::size_t id) {
+            try {
+                std::size_t chunk;
+                while (pop(id, chunk) || steal(id, chunk)) {
+                    std::size_t end = (chunk + 1) * size < shots ? (chunk + 1) * size : shots;
+                    batch(id, chunk * size, end);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                for (std::size_t k = 0; k < _pool->nthreads; k++) _queues[k].range.store(0);
+            }
+        });
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    uint64_t Trajectories::Seed(uint64_t seed, std::size_t shot) {
+        uint64_t z = seed + (uint64_t(shot) + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+}
@@ -0,0 +1,22 @@
+OPENQASM 2.0;
+
+include "qelib1.inc";
+
+opaque magic(a) q;
+gate g(a, b) x, y { u3(a*2, -b/3, (a+b)^2) x; cu1(sin(a)) x, y; barrier x, y; }
+gate wrap q { h q; magic(0.1) q; }
+
+qreg a[3];
+qreg b[3];
+qreg c[3];
+creg m[3];
+
+h a;
+g(0.3, pi/5) a, b;
+U(-pi/2 + 2*3 + 1, (1+2)*sqrt(2), 2^3^2/100) c[0];
+ccx a, b, c;
+cswap a[0], b, c;
+barrier a, b[1], c;
+measure a -> m;
+if (m == 5) g(0.1, 0.2) b[0], c[2];
+reset b;
@@ -0,0 +1,25 @@
+#!/bin/sh
+
+KAZM=$(cd "$(dirname "${1:-./kazm}")" && pwd)/$(basename "${1:-./kazm}")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+status=0
+for f in "$(dirname "$0")"/*.qasm; do
+    (
+        rm -f "$TMP/ir.kir" &&
+        cd "$(dirname "$f")" &&
+        "$KAZM" "$(basename "$f")" > "$TMP/parsed" 2>&1 &&
+        "$KAZM" --emit-ir "$TMP/ir.kir" "$(basename "$f")" > /dev/null 2>&1 &&
+        "$KAZM" --load-ir "$TMP/ir.kir" > "$TMP/loaded" 2>&1 &&
+        diff -u "$TMP/parsed" "$TMP/loaded"
+    )
+    if [ $? -eq 0 ]; then
+        echo "ok   $f"
+    else
+        echo "FAIL $f"
+        status=1
+    fi
+done
+
+exit $status
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Parser.h>
+#include <Simulator.h>
+#include <Kernels.h>
+
+typedef std::map<std::string, std::size_t> Counts;
+
+static void generate(const std::string& filename, const std::string& library, const std::string& theta, const std::string& phi) {
+    std::ofstream out(filename);
+    out << "OPENQASM 2.0;\n";
+    out << "include \"" << library << "\";\n";
+    out << "qreg q[6];\n";
+    out << "creg c[6];\n";
+    out << "layer(" << theta << ", " << phi << ") q[0], q[1], q[2];\n";
+    out << "layer(" << theta << "*2, " << phi << "+1) q[3], q[4], q[5];\n";
+    out << "h q;\n";
+    out << "cx q[0], q[3];\n";
+    out << "barrier q;\n";
+    out << "measure q -> c;\n";
+}
+
+static Counts simulate(kazm::Parser& parser) {
+    kazm::Simulator simulator(parser.program, parser.qubit_space, parser.clbit_space);
+    simulator.seed = 1;
+    simulator.threads = 2;
+    simulator.fusion = 2;
+    return simulator.run(256);
+}
+
+static std::vector<Counts> sweep(kazm::Parser& parser, const std::vector<std::vector<double> >& sets) {
+    kazm::Simulator simulator(parser.program, parser.qubit_space, parser.clbit_space);
+    simulator.seed = 1;
+    simulator.threads = 2;
+    return simulator.sweep(sets, 256);
+}
+
+static kazm::Gate* find(kazm::Parser& parser, const std::string& name) {
+    for (kazm::Gate* g : parser.gates) {
+        if (g && g->name == name) return g;
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t nthreads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+    std::size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    std::string library = "stress_lib.inc";
+    std::string fixed = "stress_fixed.qasm";
+    std::string symbolic = "stress_symbolic.qasm";
+    {
+        std::ofstream out(library);
+        out << "gate h a { U(pi/2, 0, pi) a; }\n";
+        out << "gate cx c, t { CX c, t; }\n";
+        out << "gate ry(theta) a { U(theta, 0, 0) a; }\n";
+        out << "gate rz(phi) a { U(0, 0, phi) a; }\n";
+        out << "gate layer(theta, phi) a, b, c { h a; cx a, b; ry(theta) b; cx b, c; rz(phi/2) c; barrier a, b, c; }\n";
+    }
+    generate(fixed, library, "0.7", "0.3");
+    generate(symbolic, library, "theta", "phi");
+
+    kazm::Parser shared;
+    shared.parse(fixed);
+    kazm::Parser swept;
+    swept.symbolic = true;
+    swept.parse(symbolic);
+
+    std::vector<std::vector<double> > sets = {{0.7, 0.3}, {1.1, 0.2}, {2.5, -1.0}};
+    std::vector<double> args = {0.7, 0.3};
+    kazm::KernelType kernel = kazm::Kernels::Detect();
+    kazm::Gate* layer = find(shared, "layer");
+
+    std::string text = shared.str();
+    Counts counts = simulate(shared);
+    std::vector<Counts> swept_counts = sweep(swept, sets);
+    std::vector<std::complex<double> > matrix;
+    layer->unitary(args, kernel, matrix);
+
+    std::atomic<std::size_t> failures(0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < nthreads; t++) {
+        threads.emplace_back([&]() {
+            for (std::size_t i = 0; i < iterations; i++) {
+                try {
+                    kazm::Parser parser;
+                    parser.parse(fixed);
+                    if (parser.str() != text) failures++;
+                    if (simulate(parser) != counts) failures++;
+                    if (simulate(shared) != counts) failures++;
+                    if (sweep(swept, sets) != swept_counts) failures++;
+                    std::vector<std::complex<double> > m;
+                    layer->unitary(args, kernel, m);
+                    if (m != matrix) failures++;
+                    find(parser, "layer")->unitary(args, kernel, m);
+                    if (m != matrix) failures++;
+                }
+                catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    failures++;
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+
+    std::remove(library.c_str());
+    std::remove(fixed.c_str());
+    std::remove(symbolic.c_str());
+
+    std::cout << "stress: " << nthreads << " threads, " << iterations << " iterations, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}